@@ -288,6 +288,7 @@ box64context_t *NewBox64Context(int argc)
     
     #ifdef DYNAREC
     context->db_sizes = init_rbtree();
+    context->db_strongmem = init_rbtree();
     #endif
 
     return context;
@@ -316,6 +317,7 @@ void FreeBox64Context(box64context_t** context)
         FreeElfHeader(&ctx->elfs[i]);
     }
     box_free(ctx->elfs);
+    FreeElfRanges(ctx);
 
     FreeCollection(&ctx->box64_path);
     FreeCollection(&ctx->box64_ld_lib);
@@ -390,6 +392,7 @@ void FreeBox64Context(box64context_t** context)
 #ifdef DYNAREC
     //dynarec_log(LOG_INFO, "BOX64 Dynarec at exit: Max DB=%d, righter=%d\n", ctx->max_db_size, rb_get_righter(ctx->db_sizes));
     delete_rbtree(ctx->db_sizes);
+    delete_rbtree(ctx->db_strongmem);
 #endif
 
     finiAllHelpers(ctx);
@@ -424,6 +427,9 @@ int AddElfHeader(box64context_t* ctx, elfheader_t* head) {
         ctx->elfs[idx] = head;
     }
     printf_log(LOG_DEBUG, "Adding \"%s\" as #%d in elf collection\n", ElfName(head), idx);
+    if(!idx)
+        NegCacheInvalidateAll();    // main elf is searched for all global symbols
+    RefreshElfRanges(ctx);
     return idx;
 }
 
@@ -441,6 +447,9 @@ void RemoveElfHeader(box64context_t* ctx, elfheader_t* head) {
     for(int i=0; i<ctx->elfsize; ++i)
         if(ctx->elfs[i] == head) {
             ctx->elfs[i] = NULL;
+            if(!i)
+                NegCacheInvalidateAll();
+            RefreshElfRanges(ctx);
             return;
         }
 }
@@ -39,6 +39,7 @@
 #include "elfs/elfloader_private.h"
 #include "library.h"
 #include "core.h"
+#include "perfmap.h"
 
 #ifdef CS2
 #include "cs2c.h"
@@ -90,6 +91,12 @@ int box64_dynarec_forced = 0;
 int box64_dynarec_bigblock = 1;
 int box64_dynarec_forward = 128;
 int box64_dynarec_strongmem = 0;
+int box64_dynarec_strongmem_auto = 0;
+int box64_dynarec_rcpc = 0;
+int box64_dynarec_sve = 1;
+int box64_dynarec_nativeflags = 0;
+int box64_dynarec_deadflags = 0;
+int box64_dynarec_storefwd = 0;
 int box64_dynarec_x87double = 0;
 int box64_dynarec_div0 = 0;
 int box64_dynarec_fastnan = 1;
@@ -99,8 +106,10 @@ int box64_dynarec_callret = 0;
 int box64_dynarec_bleeding_edge = 1;
 int box64_dynarec_tbb = 1;
 int box64_dynarec_wait = 1;
+int box64_dynarec_syscall = 0;
 int box64_dynarec_missing = 0;
 int box64_dynarec_aligned_atomics = 0;
+int box64_dynarec_perf_map = 0;
 uintptr_t box64_nodynarec_start = 0;
 uintptr_t box64_nodynarec_end = 0;
 uintptr_t box64_dynarec_test_start = 0;
@@ -114,11 +123,15 @@ int arm64_atomics = 0;
 int arm64_sha1 = 0;
 int arm64_sha2 = 0;
 int arm64_uscat = 0;
+int arm64_lrcpc = 0;
+int arm64_lrcpc2 = 0;
 int arm64_flagm = 0;
 int arm64_flagm2 = 0;
 int arm64_frintts = 0;
 int arm64_afp = 0;
 int arm64_rndr = 0;
+int arm64_sve = 0;
+int arm64_sve_vl = 0;
 #elif defined(RV64)
 int rv64_zba = 0;
 int rv64_zbb = 0;
@@ -190,6 +203,9 @@ int box64_wine = 0;
 int box64_musl = 0;
 int box64_nopulse = 0;
 int box64_nogtk = 0;
+int box64_reloc_cache = 0;
+int box64_reloc_threads = 0;
+int box64_native_strings = 0;
 int box64_novulkan = 0;
 int box64_showsegv = 0;
 int box64_showbt = 0;
@@ -448,10 +464,28 @@ HWCAP2_AFP
     if(hwcap&HWCAP_USCAT)
         arm64_uscat = 1;
     #endif
+    #ifdef HWCAP_LRCPC
+    if(hwcap&HWCAP_LRCPC)
+        arm64_lrcpc = 1;
+    #endif
+    #ifdef HWCAP_ILRCPC
+    if(hwcap&HWCAP_ILRCPC)
+        arm64_lrcpc2 = 1;
+    #endif
     #ifdef HWCAP_FLAGM
     if(hwcap&HWCAP_FLAGM)
         arm64_flagm = 1;
     #endif
+    #ifdef HWCAP_SVE
+    if(hwcap&HWCAP_SVE) {
+        arm64_sve = 1;
+        #ifdef PR_SVE_GET_VL
+        int vl = prctl(PR_SVE_GET_VL);
+        if(vl>0)
+            arm64_sve_vl = (vl&PR_SVE_VL_LEN_MASK)*8;
+        #endif
+    }
+    #endif
     unsigned long hwcap2 = real_getauxval(AT_HWCAP2);
     #ifdef HWCAP2_FLAGM2
     if(hwcap2&HWCAP2_FLAGM2)
@@ -484,6 +518,10 @@ HWCAP2_AFP
         printf_log(LOG_INFO, " SHA2");
     if(arm64_uscat)
         printf_log(LOG_INFO, " USCAT");
+    if(arm64_lrcpc)
+        printf_log(LOG_INFO, " LRCPC");
+    if(arm64_lrcpc2)
+        printf_log(LOG_INFO, " LRCPC2");
     if(arm64_flagm)
         printf_log(LOG_INFO, " FLAGM");
     if(arm64_flagm2)
@@ -494,6 +532,12 @@ HWCAP2_AFP
         printf_log(LOG_INFO, " AFP");
     if(arm64_rndr)
         printf_log(LOG_INFO, " RNDR");
+    if(arm64_sve) {
+        if(arm64_sve_vl)
+            printf_log(LOG_INFO, " SVE(%d bits)", arm64_sve_vl);
+        else
+            printf_log(LOG_INFO, " SVE");
+    }
 #elif defined(LA64)
     printf_log(LOG_INFO, "Dynarec for LoongArch ");
     char* p = getenv("BOX64_DYNAREC_LA64NOEXT");
@@ -773,6 +817,60 @@ void LoadLogEnv()
         if(box64_dynarec_strongmem)
             printf_log(LOG_INFO, "Dynarec will try to emulate a strong memory model%s\n", (box64_dynarec_strongmem==1)?" with limited performance loss":((box64_dynarec_strongmem>1)?" with more performance loss":""));
     }
+    p = getenv("BOX64_DYNAREC_STRONGMEM_AUTO");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_strongmem_auto = p[0]-'0';
+        }
+        if(box64_dynarec_strongmem_auto)
+            printf_log(LOG_INFO, "Dynarec will emulate a strong memory model only on code pages using LOCK opcodes\n");
+    }
+    p = getenv("BOX64_DYNAREC_RCPC");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_rcpc = p[0]-'0';
+        }
+        if(box64_dynarec_rcpc)
+            printf_log(LOG_INFO, "Dynarec will use Load-Acquire/Store-Release for strongmem MOV\n");
+    }
+    p = getenv("BOX64_DYNAREC_SVE");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_sve = p[0]-'0';
+        }
+        if(!box64_dynarec_sve)
+            printf_log(LOG_INFO, "Dynarec will not use SVE\n");
+    }
+    p = getenv("BOX64_DYNAREC_NATIVEFLAGS");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_nativeflags = p[0]-'0';
+        }
+        if(box64_dynarec_nativeflags)
+            printf_log(LOG_INFO, "Dynarec will use native flags for CMP/TEST + Jcc\n");
+    }
+    p = getenv("BOX64_DYNAREC_DEADFLAGS");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_deadflags = p[0]-'0';
+        }
+        if(box64_dynarec_deadflags)
+            printf_log(LOG_INFO, "Dynarec will look past the end of a block for dead flags\n");
+    }
+    p = getenv("BOX64_DYNAREC_STOREFWD");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_storefwd = p[0]-'0';
+        }
+        if(box64_dynarec_storefwd)
+            printf_log(LOG_INFO, "Dynarec will forward stored values to loads inside a block\n");
+    }
     p = getenv("BOX64_DYNAREC_X87DOUBLE");
     if(p) {
         if(strlen(p)==1) {
@@ -867,6 +965,15 @@ void LoadLogEnv()
         if(!box64_dynarec_wait)
             printf_log(LOG_INFO, "Dynarec will not wait for FillBlock to ready and use Interpreter instead\n");
     }
+    p = getenv("BOX64_DYNAREC_SYSCALL");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_syscall = p[0]-'0';
+        }
+        if(box64_dynarec_syscall)
+            printf_log(LOG_INFO, "Dynarec will inline pass-through syscalls\n");
+    }
     p = getenv("BOX64_DYNAREC_ALIGNED_ATOMICS");
     if(p) {
         if(strlen(p)==1) {
@@ -885,6 +992,15 @@ void LoadLogEnv()
         if(box64_dynarec_missing)
             printf_log(LOG_INFO, "Dynarec will print missing opcodes\n");
     }
+    p = getenv("BOX64_DYNAREC_PERFMAP");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='2')
+                box64_dynarec_perf_map = p[0]-'0';
+        }
+        if(box64_dynarec_perf_map)
+            printf_log(LOG_INFO, "Dynarec will generate a %s for perf\n", (box64_dynarec_perf_map==1)?"perf map":"jitdump");
+    }
     p = getenv("BOX64_NODYNAREC");
     if(p) {
         if (strchr(p,'-')) {
@@ -1098,6 +1214,32 @@ void LoadLogEnv()
         if(box64_nogtk)
             printf_log(LOG_INFO, "Disable the use of wrapped gtk libs\n");
     }
+    p = getenv("BOX64_RELOCCACHE");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='0'+1)
+                box64_reloc_cache = p[0]-'0';
+        }
+        if(box64_reloc_cache)
+            printf_log(LOG_INFO, "Use a persistent cache for symbol bindings of relocations\n");
+    }
+    p = getenv("BOX64_NATIVE_STRINGS");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='0'+1)
+                box64_native_strings = p[0]-'0';
+        }
+        if(box64_native_strings)
+            printf_log(LOG_INFO, "Redirect x86_64 string functions of emulated libs to native libc\n");
+    }
+    p = getenv("BOX64_RELOC_THREADS");
+    if(p) {
+        int nb = 0;
+        if(sscanf(p, "%d", &nb)==1)
+            box64_reloc_threads = (nb<0)?0:nb;
+        if(box64_reloc_threads>1)
+            printf_log(LOG_INFO, "Relocate needed libs on up to %d threads\n", box64_reloc_threads);
+    }
     p = getenv("BOX64_NOVULKAN");
     if(p) {
         if(strlen(p)==1) {
@@ -1386,6 +1528,9 @@ void PrintFlags() {
     printf(" BOX64_CRASHHANDLER=0 to not use a dummy crashhandler lib\n");
     printf(" BOX64_NOPULSE=1 to disable the loading of pulseaudio libs\n");
     printf(" BOX64_NOGTK=1 to disable the loading of wrapped gtk libs\n");
+    printf(" BOX64_RELOCCACHE=1 to keep the symbol bindings of relocations in a disk cache\n");
+    printf(" BOX64_RELOC_THREADS=N to relocate needed libs on up to N threads\n");
+    printf(" BOX64_NATIVE_STRINGS=0 to not redirect x86_64 string/memory variants of emulated libs to native libc\n");
     printf(" BOX64_NOVULKAN=1 to disable the loading of wrapped vulkan libs\n");
     printf(" BOX64_ENV='XXX=yyyy' will add XXX=yyyy env. var.\n");
     printf(" BOX64_ENV1='XXX=yyyy' will add XXX=yyyy env. var. and continue with BOX86_ENV2 ... until var doesn't exist\n");
@@ -1744,6 +1889,7 @@ void endBox64()
     #ifdef DYNAREC
     // disable dynarec now
     box64_dynarec = 0;
+    closePerfMap();
     #endif
     if(box64_libGL) {
         box_free(box64_libGL);
@@ -2441,6 +2587,7 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
             }
             free_neededlib(tmp);
         }
+        NegCacheInvalidateAll();    // preloaded libs are searched first
     }
     FreeCollection(&ld_preload);
     // Call librarian to load all dependant elf
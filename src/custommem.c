@@ -45,6 +45,19 @@ static uintptr_t***        box64_jmptbl3[1<<JMPTABL_SHIFT3];
 static uintptr_t**         box64_jmptbldefault2[1<<JMPTABL_SHIFT2];
 static uintptr_t*          box64_jmptbldefault1[1<<JMPTABL_SHIFT1];
 static uintptr_t           box64_jmptbldefault0[1<<JMPTABL_SHIFT0];
+// the part of the jump table for the low 4GB is static, so getJumpTable32 is stable and lookups can skip the upper levels
+#ifdef JMPTABL_SHIFT4
+static uintptr_t***        box64_jmptbllow3[1<<JMPTABL_SHIFT3];
+#endif
+static uintptr_t**         box64_jmptbl32[1<<JMPTABL_SHIFT2];
+// Jump table protocol (readers take no lock):
+//  - a missing level points to the matching "default" level, whose entries all end up at native_next
+//  - levels are created in create_jmptbl and published with native_lock_storeifref over the default one,
+//    and are only freed in fini_custommem_helper, so a walk can never reach freed memory
+//  - entries are only written with native_lock_* atomics and point either to native_next or to the native
+//    code of a dynablock (block or jmpnext), with the dynablock_t* stored just before it
+//  - readers rely only on the ordering of dependent loads, like the generated code does. A reader can get a
+//    dynablock being invalidated, DBGetBlock catch that with getNeedTest and re-check under mutex_dyndump
 // lock addresses
 KHASH_SET_INIT_INT64(lockaddress)
 static kh_lockaddress_t    *lockaddress = NULL;
@@ -443,6 +456,102 @@ static sigset_t     critical_prot = {0};
                             }
 #define UNLOCK_PROT_READ()  mutex_unlock(&mutex_prot); pthread_sigmask(SIG_SETMASK, &old_sig, NULL)
 
+// Page table mirroring memprot, so getProtection can read it without lock nor signal mask (it's called a lot,
+// including from the signal handler). Only modified with mutex_prot held, alongside memprot.
+// Levels are allocated on demand and never freed before finiAllHelpers, so readers only need atomic loads.
+#define MEMPROT_SHIFT0      12  // 4K granularity, also works with bigger box64_pagesize
+#define MEMPROT_BITS        12
+#define MEMPROT_SIZE        (1<<MEMPROT_BITS)
+#define MEMPROT_MAX         (1ULL<<(MEMPROT_SHIFT0+3*MEMPROT_BITS))  // 48bits, higher addresses use memprot
+static uint16_t**   memprot_tbl[MEMPROT_SIZE] = {0};
+static int          memprot_tbl_broken = 0;   // an allocation failed, table is not usable anymore
+
+static uint16_t* memprot_tbl_leaf(uintptr_t page, int alloc)
+{
+    uintptr_t idx2 = page>>(2*MEMPROT_BITS);
+    uintptr_t idx1 = (page>>MEMPROT_BITS)&(MEMPROT_SIZE-1);
+    uint16_t** l1 = __atomic_load_n(&memprot_tbl[idx2], __ATOMIC_ACQUIRE);
+    if(!l1) {
+        if(!alloc)
+            return NULL;
+        l1 = (uint16_t**)internal_mmap(NULL, MEMPROT_SIZE*sizeof(uint16_t*), PROT_READ|PROT_WRITE, MAP_ANONYMOUS|MAP_PRIVATE, -1, 0);
+        if(l1==MAP_FAILED)
+            return NULL;
+        __atomic_store_n(&memprot_tbl[idx2], l1, __ATOMIC_RELEASE);
+    }
+    uint16_t* l0 = __atomic_load_n(&l1[idx1], __ATOMIC_ACQUIRE);
+    if(!l0) {
+        if(!alloc)
+            return NULL;
+        l0 = (uint16_t*)internal_mmap(NULL, MEMPROT_SIZE*sizeof(uint16_t), PROT_READ|PROT_WRITE, MAP_ANONYMOUS|MAP_PRIVATE, -1, 0);
+        if(l0==MAP_FAILED)
+            return NULL;
+        __atomic_store_n(&l1[idx1], l0, __ATOMIC_RELEASE);
+    }
+    return l0;
+}
+
+// mutex_prot must be held
+static void memprot_tbl_set(uintptr_t start, uintptr_t end, uint32_t prot)
+{
+    if(memprot_tbl_broken || start>=MEMPROT_MAX || start>=end)
+        return;
+    if(end>MEMPROT_MAX)
+        end = MEMPROT_MAX;
+    uintptr_t page = start>>MEMPROT_SHIFT0;
+    uintptr_t last = (end-1)>>MEMPROT_SHIFT0;
+    while(page<=last) {
+        uintptr_t lend = page|(MEMPROT_SIZE-1);
+        if(lend>last)
+            lend = last;
+        uint16_t* leaf = memprot_tbl_leaf(page, prot?1:0);
+        if(leaf) {
+            for(uintptr_t i=page; i<=lend; ++i)
+                __atomic_store_n(&leaf[i&(MEMPROT_SIZE-1)], (uint16_t)prot, __ATOMIC_RELAXED);
+        } else if(prot) {
+            printf_log(LOG_INFO, "Warning, cannot allocate memory protection table, falling back to locked reads\n");
+            __atomic_store_n(&memprot_tbl_broken, 1, __ATOMIC_RELEASE);
+            return;
+        }
+        page = lend+1;
+    }
+}
+
+// return 1 and set prot if the table can be used for addr
+static inline int memprot_tbl_get(uintptr_t addr, uint32_t* prot)
+{
+    if(addr>=MEMPROT_MAX || __atomic_load_n(&memprot_tbl_broken, __ATOMIC_ACQUIRE))
+        return 0;
+    uintptr_t page = addr>>MEMPROT_SHIFT0;
+    uint16_t* leaf = memprot_tbl_leaf(page, 0);
+    *prot = leaf?__atomic_load_n(&leaf[page&(MEMPROT_SIZE-1)], __ATOMIC_RELAXED):0;
+    return 1;
+}
+
+static void memprot_tbl_free(void)
+{
+    for(int i=0; i<MEMPROT_SIZE; ++i)
+        if(memprot_tbl[i]) {
+            for(int j=0; j<MEMPROT_SIZE; ++j)
+                if(memprot_tbl[i][j])
+                    internal_munmap(memprot_tbl[i][j], MEMPROT_SIZE*sizeof(uint16_t));
+            internal_munmap(memprot_tbl[i], MEMPROT_SIZE*sizeof(uint16_t*));
+            memprot_tbl[i] = NULL;
+        }
+}
+
+// memprot modifications, mutex_prot must be held
+static void memprot_set(uintptr_t start, uintptr_t end, uint32_t prot)
+{
+    rb_set(memprot, start, end, prot);
+    memprot_tbl_set(start, end, prot);
+}
+static void memprot_unset(uintptr_t start, uintptr_t end)
+{
+    rb_unset(memprot, start, end);
+    memprot_tbl_set(start, end, 0);
+}
+
 
 #ifdef TRACE_MEMSTAT
 static uint64_t customMalloc_allocated = 0;
@@ -912,6 +1021,21 @@ void FreeDynarecMap(uintptr_t addr)
     }
 }
 
+// read the jump table entry for addr, without lock (see the protocol above)
+static inline uintptr_t jmptbl_get(uintptr_t addr)
+{
+    uintptr_t*** tbl;
+    if(addr<0x100000000LL)
+        tbl = box64_jmptbl32;
+    else
+        #ifdef JMPTABL_SHIFT4
+        tbl = box64_jmptbl4[(addr>>JMPTABL_START4)&JMPTABLE_MASK4][(addr>>JMPTABL_START3)&JMPTABLE_MASK3];
+        #else
+        tbl = box64_jmptbl3[(addr>>JMPTABL_START3)&JMPTABLE_MASK3];
+        #endif
+    return *(volatile uintptr_t*)&tbl[(addr>>JMPTABL_START2)&JMPTABLE_MASK2][(addr>>JMPTABL_START1)&JMPTABLE_MASK1][addr&JMPTABLE_MASK0];
+}
+
 static uintptr_t getDBSize(uintptr_t addr, size_t maxsize, dynablock_t** db)
 {
     #ifdef JMPTABL_START4
@@ -1184,25 +1308,7 @@ int setJumpTableIfRef64(void* addr, void* jmp, void* ref)
 }
 int isJumpTableDefault64(void* addr)
 {
-    uintptr_t idx3, idx2, idx1, idx0;
-    #ifdef JMPTABL_SHIFT4
-    uintptr_t idx4;
-    idx4 = (((uintptr_t)addr)>>JMPTABL_START4)&JMPTABLE_MASK4;
-    if(box64_jmptbl4[idx4] == box64_jmptbldefault3)
-        return 1;
-    uintptr_t ****box64_jmptbl3 = box64_jmptbl4[idx4];
-    #endif
-    idx3 = (((uintptr_t)addr)>>JMPTABL_START3)&JMPTABLE_MASK3;
-    if(box64_jmptbl3[idx3] == box64_jmptbldefault2)
-        return 1;
-    idx2 = (((uintptr_t)addr)>>JMPTABL_START2)&JMPTABLE_MASK2;
-    if(box64_jmptbl3[idx3][idx2] == box64_jmptbldefault1)
-        return 1;
-    idx1 = (((uintptr_t)addr)>>JMPTABL_START1)&JMPTABLE_MASK1;
-    if(box64_jmptbl3[idx3][idx2][idx1] == box64_jmptbldefault0)
-        return 1;
-    idx0 = (((uintptr_t)addr)    )&JMPTABLE_MASK0;
-    return (box64_jmptbl3[idx3][idx2][idx1][idx0]==(uintptr_t)native_next)?1:0;
+    return (jmptbl_get((uintptr_t)addr)==(uintptr_t)native_next)?1:0;
 }
 uintptr_t getJumpTable64()
 {
@@ -1215,11 +1321,7 @@ uintptr_t getJumpTable64()
 
 uintptr_t getJumpTable32()
 {
-    #ifdef JMPTABL_SHIFT4
-    return (uintptr_t)box64_jmptbl4[0][0];
-    #else
-    return (uintptr_t)box64_jmptbl3[0];
-    #endif
+    return (uintptr_t)box64_jmptbl32;
 }
 
 uintptr_t getJumpTableAddress64(uintptr_t addr)
@@ -1241,57 +1343,20 @@ uintptr_t getJumpTableAddress64(uintptr_t addr)
 
 dynablock_t* getDB(uintptr_t addr)
 {
-    uintptr_t idx3, idx2, idx1, idx0;
-    #ifdef JMPTABL_SHIFT4
-    uintptr_t idx4 = (((uintptr_t)addr)>>JMPTABL_START4)&JMPTABLE_MASK4;
-    #endif
-    idx3 = ((addr)>>JMPTABL_START3)&JMPTABLE_MASK3;
-    idx2 = ((addr)>>JMPTABL_START2)&JMPTABLE_MASK2;
-    idx1 = ((addr)>>JMPTABL_START1)&JMPTABLE_MASK1;
-    idx0 = ((addr)                )&JMPTABLE_MASK0;
-    #ifdef JMPTABL_SHIFT4
-    uintptr_t ret = (uintptr_t)box64_jmptbl4[idx4][idx3][idx2][idx1][idx0];
-    #else
-    uintptr_t ret = (uintptr_t)box64_jmptbl3[idx3][idx2][idx1][idx0];
-    #endif
-
+    uintptr_t ret = jmptbl_get(addr);
     return *(dynablock_t**)(ret - sizeof(void*));
 }
 
 int getNeedTest(uintptr_t addr)
 {
-    uintptr_t idx3, idx2, idx1, idx0;
-    #ifdef JMPTABL_SHIFT4
-    uintptr_t idx4 = (((uintptr_t)addr)>>JMPTABL_START4)&JMPTABLE_MASK4;
-    #endif
-    idx3 = ((addr)>>JMPTABL_START3)&JMPTABLE_MASK3;
-    idx2 = ((addr)>>JMPTABL_START2)&JMPTABLE_MASK2;
-    idx1 = ((addr)>>JMPTABL_START1)&JMPTABLE_MASK1;
-    idx0 = ((addr)                )&JMPTABLE_MASK0;
-    #ifdef JMPTABL_SHIFT4
-    uintptr_t ret = (uintptr_t)box64_jmptbl4[idx4][idx3][idx2][idx1][idx0];
-    #else
-    uintptr_t ret = (uintptr_t)box64_jmptbl3[idx3][idx2][idx1][idx0];
-    #endif
+    uintptr_t ret = jmptbl_get(addr);
     dynablock_t* db = *(dynablock_t**)(ret - sizeof(void*));
     return db?((ret!=(uintptr_t)db->block)?1:0):0;
 }
 
 uintptr_t getJumpAddress64(uintptr_t addr)
 {
-    uintptr_t idx3, idx2, idx1, idx0;
-    #ifdef JMPTABL_SHIFT4
-    uintptr_t idx4 = (((uintptr_t)addr)>>JMPTABL_START4)&JMPTABLE_MASK4;
-    #endif
-    idx3 = ((addr)>>JMPTABL_START3)&JMPTABLE_MASK3;
-    idx2 = ((addr)>>JMPTABL_START2)&JMPTABLE_MASK2;
-    idx1 = ((addr)>>JMPTABL_START1)&JMPTABLE_MASK1;
-    idx0 = ((addr)                )&JMPTABLE_MASK0;
-    #ifdef JMPTABL_SHIFT4
-    return (uintptr_t)box64_jmptbl4[idx4][idx3][idx2][idx1][idx0];
-    #else
-    return (uintptr_t)box64_jmptbl3[idx3][idx2][idx1][idx0];
-    #endif
+    return jmptbl_get(addr);
 }
 
 // Remove the Write flag from an adress range, so DB can be executed safely
@@ -1323,7 +1388,7 @@ void protectDBJumpTable(uintptr_t addr, size_t size, void* jump, void* ref)
                 prot |= PROT_DYNAREC_R;
         }
         if (prot != oprot) // If the node doesn't exist, then prot != 0
-            rb_set(memprot, cur, bend, prot);
+            memprot_set(cur, bend, prot);
         cur = bend;
     }
     if(jump)
@@ -1360,7 +1425,7 @@ void protectDB(uintptr_t addr, uintptr_t size)
                 prot |= PROT_DYNAREC_R;
         }
         if (prot != oprot) // If the node doesn't exist, then prot != 0
-            rb_set(memprot, cur, bend, prot);
+            memprot_set(cur, bend, prot);
         cur = bend;
     }
     UNLOCK_PROT();
@@ -1398,7 +1463,7 @@ void unprotectDB(uintptr_t addr, size_t size, int mark)
                 prot &= ~PROT_CUSTOM;
         }
         if (prot != oprot)
-            rb_set(memprot, cur, bend, prot);
+            memprot_set(cur, bend, prot);
         cur = bend;
     }
     UNLOCK_PROT();
@@ -1409,6 +1474,17 @@ int isprotectedDB(uintptr_t addr, size_t size)
     dynarec_log(LOG_DEBUG, "isprotectedDB %p -> %p => ", (void*)addr, (void*)(addr+size-1));
     addr &=~(box64_pagesize-1);
     uintptr_t end = ALIGN(addr+size);
+    if(end<=MEMPROT_MAX && !__atomic_load_n(&memprot_tbl_broken, __ATOMIC_ACQUIRE)) {
+        for(uintptr_t cur=addr; cur<end; cur+=1<<MEMPROT_SHIFT0) {
+            uint32_t prot;
+            if(!memprot_tbl_get(cur, &prot) || !(prot&PROT_DYN)) {
+                dynarec_log(LOG_DEBUG, "0\n");
+                return 0;
+            }
+        }
+        dynarec_log(LOG_DEBUG, "1\n");
+        return 1;
+    }
     LOCK_PROT_READ();
     while (addr < end) {
         uint32_t prot;
@@ -1471,7 +1547,7 @@ void updateProtection(uintptr_t addr, size_t size, uint32_t prot)
             }
         }
         if ((prot|dyn) != oprot)
-            rb_set(memprot, cur, bend, prot|dyn);
+            memprot_set(cur, bend, prot|dyn);
         cur = bend;
     }
     UNLOCK_PROT();
@@ -1484,7 +1560,7 @@ void setProtection(uintptr_t addr, size_t size, uint32_t prot)
     uintptr_t cur = addr & ~(box64_pagesize-1);
     uintptr_t end = ALIGN(cur+size);
     rb_set(mapallmem, cur, end, 1);
-    rb_set(memprot, cur, end, prot);
+    memprot_set(cur, end, prot);
     UNLOCK_PROT();
 }
 
@@ -1498,7 +1574,7 @@ void setProtection_mmap(uintptr_t addr, size_t size, uint32_t prot)
     rb_set(mmapmem, addr, addr+size, 1);
     if(!prot) {
         rb_set(mapallmem, addr, addr+size, 1);
-        rb_unset(memprot, addr, addr+size);
+        memprot_unset(addr, addr+size);
     }
     UNLOCK_PROT();
     if(prot)
@@ -1514,7 +1590,7 @@ void setProtection_elf(uintptr_t addr, size_t size, uint32_t prot)
     else {
         LOCK_PROT();
         rb_set(mapallmem, addr, addr+size, 1);
-        rb_unset(memprot, addr, addr+size);
+        memprot_unset(addr, addr+size);
         UNLOCK_PROT();
     }
 }
@@ -1585,12 +1661,15 @@ void freeProtection(uintptr_t addr, size_t size)
         rb_unset(mapallmem, addr, addr+size);
         rb_unset(mmapmem, addr, addr+size);
     }
-    rb_unset(memprot, addr, addr+size);
+    memprot_unset(addr, addr+size);
     UNLOCK_PROT();
 }
 
 uint32_t getProtection(uintptr_t addr)
 {
+    uint32_t prot;
+    if(memprot_tbl_get(addr, &prot))
+        return prot;
     LOCK_PROT_READ();
     uint32_t ret = rb_get(memprot, addr);
     UNLOCK_PROT_READ();
@@ -1609,20 +1688,9 @@ int getMmapped(uintptr_t addr)
 
 void* find31bitBlockNearHint(void* hint, size_t size, uintptr_t mask)
 {
-    uint32_t prot;
     if(hint<LOWEST) hint = box64_wine?WINE_LOWEST:LOWEST;
-    uintptr_t bend = 0;
-    uintptr_t cur = (uintptr_t)hint;
-    if(!mask) mask = 0xffff;
-    while(bend<0xc0000000LL) {
-        if(!rb_get_end(mapallmem, cur, &prot, &bend)) {
-            if(bend-cur>=size)
-                return (void*)cur;
-        }
-        // granularity 0x10000
-        cur = (bend+mask)&~mask;
-    }
-    return NULL;
+    if(!mask) mask = 0xffff;  // granularity 0x10000
+    return (void*)rb_find_free(mapallmem, (uintptr_t)hint, 0xc0000000LL, size, mask);
 }
 
 void* find32bitBlock(size_t size)
@@ -1642,20 +1710,9 @@ void* find47bitBlock(size_t size)
 }
 void* find47bitBlockNearHint(void* hint, size_t size, uintptr_t mask)
 {
-    uint32_t prot;
     if(hint<LOWEST) hint = LOWEST;
-    uintptr_t bend = 0;
-    uintptr_t cur = (uintptr_t)hint;
-    if(!mask) mask = 0xffff;
-    while(bend<0x800000000000LL) {
-        if(!rb_get_end(mapallmem, cur, &prot, &bend)) {
-            if(bend-cur>=size)
-                return (void*)cur;
-        }
-        // granularity 0x10000
-        cur = (bend+mask)&~mask;
-    }
-    return NULL;
+    if(!mask) mask = 0xffff;  // granularity 0x10000
+    return (void*)rb_find_free(mapallmem, (uintptr_t)hint, 0x800000000000LL, size, mask);
 }
 void* find47bitBlockElf(size_t size, int mainbin, uintptr_t mask)
 {
@@ -1897,6 +1954,16 @@ void init_custommem_helper(box64context_t* ctx)
         #endif
         for(int i=0; i<(1<<JMPTABL_SHIFT2); ++i)
             box64_jmptbldefault2[i] = box64_jmptbldefault1;
+        for(int i=0; i<(1<<JMPTABL_SHIFT2); ++i)
+            box64_jmptbl32[i] = box64_jmptbldefault1;
+        #ifdef JMPTABL_SHIFT4
+        for(int i=0; i<(1<<JMPTABL_SHIFT3); ++i)
+            box64_jmptbllow3[i] = box64_jmptbldefault2;
+        box64_jmptbllow3[0] = box64_jmptbl32;
+        box64_jmptbl4[0] = box64_jmptbllow3;
+        #else
+        box64_jmptbl3[0] = box64_jmptbl32;
+        #endif
         for(int i=0; i<(1<<JMPTABL_SHIFT1); ++i)
             box64_jmptbldefault1[i] = box64_jmptbldefault0;
         for(int i=0; i<(1<<JMPTABL_SHIFT0); ++i)
@@ -1985,10 +2052,12 @@ void fini_custommem_helper(box64context_t *ctx)
                             }
                         customFree(box64_jmptbl3[i3][i2]);
                     }
-                customFree(box64_jmptbl3[i3]);
+                if(box64_jmptbl3[i3]!=box64_jmptbl32)
+                    customFree(box64_jmptbl3[i3]);
             }
         #ifdef JMPTABL_SHIFT4
-                customFree(box64_jmptbl4[i4]);
+                if(box64_jmptbl4[i4]!=box64_jmptbllow3)
+                    customFree(box64_jmptbl4[i4]);
             }
         #endif
     }
@@ -1997,6 +2066,7 @@ void fini_custommem_helper(box64context_t *ctx)
 #endif
     delete_rbtree(memprot);
     memprot = NULL;
+    memprot_tbl_free();
     delete_rbtree(mmapmem);
     mmapmem = NULL;
     delete_rbtree(mapallmem);
@@ -86,6 +86,8 @@ p0-p3 are used to pass scalable predicate arguments to a subroutine and to retur
 #define x5      5
 #define x6      6
 #define x7      7
+// syscall number for SVC
+#define x8      8
 // 32bits version of scratch
 #define w1      x1
 #define w2      x2
@@ -454,6 +456,38 @@ int convert_bitmask(uint64_t bitmask);
 #define STLXPw(Rs, Rt, Rt2, Rn)         EMIT(MEMAX_pair(0, 0, Rs, Rt2, Rn, Rt))
 #define STLXPxw(Rs, Rt, Rt2, Rn)        EMIT(MEMAX_pair(rex.w, 0, Rs, Rt2, Rn, Rt))
 
+// LOAD/STORE Acquire / Release (non exclusive)
+#define MEMAR_gen(size, L, Rn, Rt)          ((size)<<30 | 0b001000<<24 | 1<<23 | (L)<<22 | 0b11111<<16 | 1<<15 | 0b11111<<10 | (Rn)<<5 | (Rt))
+#define LDARB(Rt, Rn)                   EMIT(MEMAR_gen(0b00, 1, Rn, Rt))
+#define STLRB(Rt, Rn)                   EMIT(MEMAR_gen(0b00, 0, Rn, Rt))
+#define LDARH(Rt, Rn)                   EMIT(MEMAR_gen(0b01, 1, Rn, Rt))
+#define STLRH(Rt, Rn)                   EMIT(MEMAR_gen(0b01, 0, Rn, Rt))
+#define LDARw(Rt, Rn)                   EMIT(MEMAR_gen(0b10, 1, Rn, Rt))
+#define STLRw(Rt, Rn)                   EMIT(MEMAR_gen(0b10, 0, Rn, Rt))
+#define LDARx(Rt, Rn)                   EMIT(MEMAR_gen(0b11, 1, Rn, Rt))
+#define STLRx(Rt, Rn)                   EMIT(MEMAR_gen(0b11, 0, Rn, Rt))
+#define LDARxw(Rt, Rn)                  EMIT(MEMAR_gen(2+rex.w, 1, Rn, Rt))
+#define STLRxw(Rt, Rn)                  EMIT(MEMAR_gen(2+rex.w, 0, Rn, Rt))
+
+// LOAD Acquire RCpc (needs LRCPC)
+#define LDAPR_gen(size, Rn, Rt)             ((size)<<30 | 0b111000<<24 | 1<<23 | 1<<21 | 0b11111<<16 | 1<<15 | 0b100<<12 | (Rn)<<5 | (Rt))
+#define LDAPRB(Rt, Rn)                  EMIT(LDAPR_gen(0b00, Rn, Rt))
+#define LDAPRH(Rt, Rn)                  EMIT(LDAPR_gen(0b01, Rn, Rt))
+#define LDAPRw(Rt, Rn)                  EMIT(LDAPR_gen(0b10, Rn, Rt))
+#define LDAPRx(Rt, Rn)                  EMIT(LDAPR_gen(0b11, Rn, Rt))
+#define LDAPRxw(Rt, Rn)                 EMIT(LDAPR_gen(2+rex.w, Rn, Rt))
+// LOAD Acquire RCpc / STORE Release, with signed 9bits unscaled offset (needs LRCPC2)
+#define LDAPUR_gen(size, opc, imm9, Rn, Rt) ((size)<<30 | 0b011001<<24 | (opc)<<22 | ((imm9)&0x1ff)<<12 | (Rn)<<5 | (Rt))
+#define LDAPURB(Rt, Rn, imm9)           EMIT(LDAPUR_gen(0b00, 0b01, imm9, Rn, Rt))
+#define STLURB(Rt, Rn, imm9)            EMIT(LDAPUR_gen(0b00, 0b00, imm9, Rn, Rt))
+#define LDAPURxw(Rt, Rn, imm9)          EMIT(LDAPUR_gen(2+rex.w, 0b01, imm9, Rn, Rt))
+#define STLURxw(Rt, Rn, imm9)           EMIT(LDAPUR_gen(2+rex.w, 0b00, imm9, Rn, Rt))
+// offset is only allowed with LRCPC2
+#define LDAPB(Rt, Rn, imm9)             if(imm9) {LDAPURB(Rt, Rn, imm9);} else {LDAPRB(Rt, Rn);}
+#define STLB(Rt, Rn, imm9)              if(imm9) {STLURB(Rt, Rn, imm9);} else {STLRB(Rt, Rn);}
+#define LDAPxw(Rt, Rn, imm9)            if(imm9) {LDAPURxw(Rt, Rn, imm9);} else {LDAPRxw(Rt, Rn);}
+#define STLxw(Rt, Rn, imm9)             if(imm9) {STLURxw(Rt, Rn, imm9);} else {STLRxw(Rt, Rn);}
+
 // LOAD/STORE Exclusive
 #define MEMX_gen(size, L, Rs, Rn, Rt)       ((size)<<30 | 0b001000<<24 | (L)<<22 | (Rs)<<16 | 0<<15 | 0b11111<<10 | (Rn)<<5 | (Rt))
 #define LDXRB(Rt, Rn)                   EMIT(MEMX_gen(0b00, 1, 31, Rn, Rt))
@@ -500,6 +534,9 @@ int convert_bitmask(uint64_t bitmask);
 // Break
 #define BRK_gen(imm16)                  (0b11010100<<24 | 0b001<<21 | (((imm16)&0xffff)<<5))
 #define BRK(imm16)                      EMIT(BRK_gen(imm16))
+// Supervisor Call
+#define SVC_gen(imm16)                  (0b11010100<<24 | 0b000<<21 | (((imm16)&0xffff)<<5) | 0b01)
+#define SVC(imm16)                      EMIT(SVC_gen(imm16))
 
 // BR and Branches
 #define BR_gen(Z, op, A, M, Rn, Rm)       (0b1101011<<25 | (Z)<<24 | (op)<<21 | 0b11111<<16 | (A)<<11 | (M)<<10 | (Rn)<<5 | (Rm))
@@ -2409,4 +2446,24 @@ int convert_bitmask(uint64_t bitmask);
 //SHA256 hash update (part 2)
 #define SHA256H2(Vd, Vn, Vm)        EMIT(SHA256H2_gen(Vm, Vn, Vd))
 
+// SVE, only used on the 128bits Vn part of Zn (with a VL2/VL4 predicate), so any vector length works
+#define SVE_VL2     0b00010
+#define SVE_VL4     0b00100
+#define PTRUE_gen(size, pattern, Pd)    (0b00100101<<24 | (size)<<22 | 0b011000<<16 | 0b111000<<10 | (pattern)<<5 | (Pd))
+// set the first elements of Pd (as many as pattern says) to true
+#define PTRUE_S(Pd, pattern)            EMIT(PTRUE_gen(0b10, pattern, Pd))
+#define PTRUE_D(Pd, pattern)            EMIT(PTRUE_gen(0b11, pattern, Pd))
+#define SVE_CMPI_gen(size, imm5, op, o2, Pg, Zn, ne, Pd)    (0b00100101<<24 | (size)<<22 | ((imm5)&0x1f)<<16 | (op)<<15 | (o2)<<13 | (Pg)<<10 | (Zn)<<5 | (ne)<<4 | (Pd))
+// Pd = active elements of Pg where Zn is negative
+#define CMPLT_S_0(Pd, Pg, Zn)           EMIT(SVE_CMPI_gen(0b10, 0, 0, 1, Pg, Zn, 0, Pd))
+#define CMPLT_D_0(Pd, Pg, Zn)           EMIT(SVE_CMPI_gen(0b11, 0, 0, 1, Pg, Zn, 0, Pd))
+#define SVE_LD1_gen(dtype, Pg, Rn, Zt)  (0b1010010<<25 | (dtype)<<21 | 0b101<<13 | (Pg)<<10 | (Rn)<<5 | (Zt))
+// contiguous load of the active elements of Pg from [Rn], inactive elements are not read and set to 0
+#define LD1W_S(Zt, Pg, Rn)              EMIT(SVE_LD1_gen(0b1010, Pg, Rn, Zt))
+#define LD1D(Zt, Pg, Rn)                EMIT(SVE_LD1_gen(0b1111, Pg, Rn, Zt))
+#define SVE_ST1_gen(msz, size, Pg, Rn, Zt)  (0b1110010<<25 | (msz)<<23 | (size)<<21 | 0b111<<13 | (Pg)<<10 | (Rn)<<5 | (Zt))
+// contiguous store of the active elements of Pg to [Rn], inactive elements are not written
+#define ST1W_S(Zt, Pg, Rn)              EMIT(SVE_ST1_gen(0b10, 0b10, Pg, Rn, Zt))
+#define ST1D(Zt, Pg, Rn)                EMIT(SVE_ST1_gen(0b11, 0b11, Pg, Rn, Zt))
+
 #endif  //__ARM64_EMITTER_H__
@@ -1835,6 +1835,37 @@ const char* arm64_print(uint32_t opcode, uintptr_t addr)
         snprintf(buff, sizeof(buff), "SHA256H2 Q%d, Q%d, V%d.4S", Rd, Rn, Rm);
         return buff;
     }
+    // SVE
+    if(isMask(opcode, "00100101ff011000111000ppppp0dddd", &a)) {
+        const char* Y[] = {"B", "H", "S", "D"};
+        snprintf(buff, sizeof(buff), "PTRUE P%d.%s, VL%d", Rd, Y[sf], a.p);
+        return buff;
+    }
+    if(isMask(opcode, "00100101ff000000001aaannnnn0dddd", &a)) {
+        const char* Y[] = {"B", "H", "S", "D"};
+        snprintf(buff, sizeof(buff), "CMPLT P%d.%s, P%d/Z, Z%d.%s, #0", Rd, Y[sf], a.a, Rn, Y[sf]);
+        return buff;
+    }
+    if(isMask(opcode, "1010010ffff00000101aaannnnnttttt", &a)) {
+        if(sf==0b1010) {
+            snprintf(buff, sizeof(buff), "LD1W {Z%d.S}, P%d/Z, [%s]", Rt, a.a, XtSp[Rn]);
+            return buff;
+        }
+        if(sf==0b1111) {
+            snprintf(buff, sizeof(buff), "LD1D {Z%d.D}, P%d/Z, [%s]", Rt, a.a, XtSp[Rn]);
+            return buff;
+        }
+    }
+    if(isMask(opcode, "1110010ffff00000111aaannnnnttttt", &a)) {
+        if(sf==0b1010) {
+            snprintf(buff, sizeof(buff), "ST1W {Z%d.S}, P%d, [%s]", Rt, a.a, XtSp[Rn]);
+            return buff;
+        }
+        if(sf==0b1111) {
+            snprintf(buff, sizeof(buff), "ST1D {Z%d.D}, P%d, [%s]", Rt, a.a, XtSp[Rn]);
+            return buff;
+        }
+    }
     // UDF
     if(isMask(opcode, "0000000000000000iiiiiiiiiiiiiiii", &a)) {
         snprintf(buff, sizeof(buff), "UDF 0x%x", a.i);
@@ -996,16 +996,20 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             break;
 
         #define GO(GETFLAGS, NO, YES, F)                                \
-            READFLAGS(F);                                               \
+            if(!dyn->insts[ninst].nat_flags_fusion) {                   \
+                READFLAGS(F);                                           \
+            }                                                           \
             i8 = F8S;                                                   \
             BARRIER(BARRIER_MAYBE);                                     \
             JUMP(addr+i8, 1);                                           \
-            GETFLAGS;                                                   \
+            if(!dyn->insts[ninst].nat_flags_fusion) {                   \
+                GETFLAGS;                                               \
+            }                                                           \
             if(dyn->insts[ninst].x64.jmp_insts==-1 ||                   \
                 CHECK_CACHE()) {                                        \
                 /* out of the block */                                  \
                 i32 = dyn->insts[ninst].epilog-(dyn->native_size);      \
-                Bcond(NO, i32);                                         \
+                Bcond(NATIVECOND(NO, opcode^1), i32);                   \
                 if(dyn->insts[ninst].x64.jmp_insts==-1) {               \
                     if(!(dyn->insts[ninst].x64.barrier&BARRIER_FLOAT))  \
                         fpu_purgecache(dyn, ninst, 1, x1, x2, x3);      \
@@ -1019,7 +1023,7 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             } else {                                                    \
                 /* inside the block, no cache change */                 \
                 i32 = dyn->insts[dyn->insts[ninst].x64.jmp_insts].address-(dyn->native_size);    \
-                Bcond(YES, i32);                                        \
+                Bcond(NATIVECOND(YES, opcode), i32);                    \
             }
 
         GOCOND(0x70, "J", "ib");
@@ -1314,6 +1318,11 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                     eb2 = ((ed&4)>>2);    // L or H
                 }
                 BFIx(eb1, gd, eb2*8, 8);
+            } else if(SMRCPC()) {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, &fixedaddress, arm64_lrcpc2?&unscaled:NULL, 0, 0, rex, &lock, 0, 0);
+                if(lock) {WILLWRITELOCK(lock);}
+                STLB(gd, ed, fixedaddress);
+                if(lock) {SMWRITELOCK(lock);}
             } else {
                 addr = geted(dyn, addr, ninst, nextop, &ed, x2, &fixedaddress, &unscaled, 0xfff, 0, rex, &lock, 0, 0);
                 WILLWRITELOCK(lock);
@@ -1327,6 +1336,11 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             GETGD;
             if(MODREG) {   // reg <= reg
                 MOVxw_REG(xRAX+(nextop&7)+(rex.b<<3), gd);
+            } else if(SMRCPC()) {       // mem <= reg, with release
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, &fixedaddress, arm64_lrcpc2?&unscaled:NULL, 0, 0, rex, &lock, 0, 0);
+                if(lock) {WILLWRITELOCK(lock);}
+                STLxw(gd, ed, fixedaddress);
+                if(lock) {SMWRITELOCK(lock);}
             } else {                    // mem <= reg
                 addr = geted(dyn, addr, ninst, nextop, &ed, x2, &fixedaddress, &unscaled, 0xfff<<(2+rex.w), (1<<(2+rex.w))-1, rex, &lock, 0, 0);
                 WILLWRITELOCK(lock);
@@ -1360,6 +1374,11 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 } else {
                     ed = wback;
                 }
+            } else if(SMRCPC()) {
+                addr = geted(dyn, addr, ninst, nextop, &wback, x3, &fixedaddress, arm64_lrcpc2?&unscaled:NULL, 0, 0, rex, &lock, 0, 0);
+                SMREADLOCK(lock);
+                LDAPB(x4, wback, fixedaddress);
+                ed = x4;
             } else {
                 addr = geted(dyn, addr, ninst, nextop, &wback, x3, &fixedaddress, &unscaled, 0xfff, 0, rex, &lock, 0, 0);
                 SMREADLOCK(lock);
@@ -1374,6 +1393,14 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             GETGD;
             if(MODREG) {
                 MOVxw_REG(gd, xRAX+(nextop&7)+(rex.b<<3));
+            } else if(dyn->insts[ninst].x64.fwd_reg) {
+                // value stored there earlier in the block, still in a register: no need to compute the address
+                FAKEED;
+                MOVxw_REG(gd, xRAX+dyn->insts[ninst].x64.fwd_reg-1);
+            } else if(SMRCPC()) {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, &fixedaddress, arm64_lrcpc2?&unscaled:NULL, 0, 0, rex, &lock, 0, 0);
+                SMREADLOCK(lock);
+                LDAPxw(gd, ed, fixedaddress);
             } else {
                 addr = geted(dyn, addr, ninst, nextop, &ed, x2, &fixedaddress, &unscaled, 0xfff<<(2+rex.w), (1<<(2+rex.w))-1, rex, &lock, 0, 0);
                 SMREADLOCK(lock);
@@ -149,6 +149,23 @@ uintptr_t dynarec64_0F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             INST_NAME("SYSCALL");
             NOTEST(x1);
             SMEND();
+            if(!rex.is32bits && (i32 = isInlineSyscall(dyn, ninst, &i32_))) {
+                // pass-through syscall, done in place. xEmu is x0, so it's saved in x7 and x0 is set just before the SVC
+                // (getEmuSignal looks for that "MOV x7, xEmu" in the native code of the SYSCALL to know emu is in x7)
+                MESSAGE(LOG_DUMP, "Inline syscall %d\n", i32);
+                MOVx_REG(x7, xEmu);
+                if(i32_>1) {MOVx_REG(x1, xRSI);}
+                if(i32_>2) {MOVx_REG(x2, xRDX);}
+                if(i32_>3) {MOVx_REG(x3, xR10);}
+                if(i32_>4) {MOVx_REG(x4, xR8);}
+                if(i32_>5) {MOVx_REG(x5, xR9);}
+                MOV32w(x8, i32);
+                if(i32_>0) {MOVx_REG(xEmu, xRDI);}
+                SVC(0);
+                MOVx_REG(xRAX, xEmu);
+                MOVx_REG(xEmu, x7);
+                break;
+            }
             GETIP(addr);
             STORE_XEMU_CALL(xRIP);
             CALL_S(x64Syscall, -1);
@@ -1546,17 +1563,21 @@ uintptr_t dynarec64_0F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             }
             break;
 
-        #define GO(GETFLAGS, NO, YES, F)   \
-            READFLAGS(F);                                               \
+        #define GO(GETFLAGS, NO, YES, F)                                \
+            if(!dyn->insts[ninst].nat_flags_fusion) {                   \
+                READFLAGS(F);                                           \
+            }                                                           \
             i32_ = F32S;                                                \
             BARRIER(BARRIER_MAYBE);                                     \
             JUMP(addr+i32_, 1);                                         \
-            GETFLAGS;                                                   \
+            if(!dyn->insts[ninst].nat_flags_fusion) {                   \
+                GETFLAGS;                                               \
+            }                                                           \
             if(dyn->insts[ninst].x64.jmp_insts==-1 ||                   \
                 CHECK_CACHE()) {                                        \
                 /* out of the block */                                  \
                 i32 = dyn->insts[ninst].epilog-(dyn->native_size);      \
-                Bcond(NO, i32);                                         \
+                Bcond(NATIVECOND(NO, opcode^1), i32);                   \
                 if(dyn->insts[ninst].x64.jmp_insts==-1) {               \
                     if(!(dyn->insts[ninst].x64.barrier&BARRIER_FLOAT))  \
                         fpu_purgecache(dyn, ninst, 1, x1, x2, x3);      \
@@ -1569,7 +1590,7 @@ uintptr_t dynarec64_0F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             } else {                                                    \
                 /* inside the block */                                  \
                 i32 = dyn->insts[dyn->insts[ninst].x64.jmp_insts].address-(dyn->native_size);    \
-                Bcond(YES, i32);                                        \
+                Bcond(NATIVECOND(YES, opcode), i32);                    \
             }
 
         GOCOND(0x80, "J", "Id");
@@ -523,6 +523,23 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
         case 0x2C:
             INST_NAME("VMASKMOVPS Gx, Vx, Ex");
             nextop = F8;
+            if(arm64_sve && box64_dynarec_sve && !MODREG) {
+                // SVE predicated load: masked out elements are not read, so they can't fault
+                GETGX_empty_VX(v0, v2);
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 0);
+                SMREAD();
+                PTRUE_S(0, SVE_VL4);
+                for(int l=0; l<1+vex.l; ++l) {
+                    if(l) {
+                        GETGY_empty_VY(v0, v2, 0, -1, -1);
+                        ADDx_U12(x4, ed, 16);
+                    }
+                    CMPLT_S_0(1, 0, v2);
+                    LD1W_S(v0, 1, l?x4:ed);
+                }
+                if(!vex.l) YMM0(gd);
+                break;
+            }
             GETGX_empty_VXEX(v0, v2, v1, 0);
             q0 = fpu_get_scratch(dyn, ninst);
             // create mask
@@ -537,6 +554,23 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
         case 0x2D:
             INST_NAME("VMASKMOVPD Gx, Vx, Ex");
             nextop = F8;
+            if(arm64_sve && box64_dynarec_sve && !MODREG) {
+                // SVE predicated load: masked out elements are not read, so they can't fault
+                GETGX_empty_VX(v0, v2);
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 0);
+                SMREAD();
+                PTRUE_D(0, SVE_VL2);
+                for(int l=0; l<1+vex.l; ++l) {
+                    if(l) {
+                        GETGY_empty_VY(v0, v2, 0, -1, -1);
+                        ADDx_U12(x4, ed, 16);
+                    }
+                    CMPLT_D_0(1, 0, v2);
+                    LD1D(v0, 1, l?x4:ed);
+                }
+                if(!vex.l) YMM0(gd);
+                break;
+            }
             GETGX_empty_VXEX(v0, v2, v1, 0);
             q0 = fpu_get_scratch(dyn, ninst);
             // create mask
@@ -551,6 +585,24 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
         case 0x2E:
             INST_NAME("VMASKMOVPS Ex, Gx, Vx");
             nextop = F8;
+            if(arm64_sve && box64_dynarec_sve && !MODREG) {
+                // SVE predicated store: masked out elements are not written, nor read
+                GETVX(v2, 0);
+                GETGX(v0, 0);
+                WILLWRITE2();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 0);
+                PTRUE_S(0, SVE_VL4);
+                CMPLT_S_0(1, 0, v2);
+                ST1W_S(v0, 1, ed);
+                if(vex.l && !is_avx_zero(dyn, ninst, vex.v)) {
+                    v2 = ymm_get_reg(dyn, ninst, x1, vex.v, 0, gd, -1, -1);
+                    v0 = ymm_get_reg(dyn, ninst, x1, gd, 0, vex.v, -1, -1);
+                    CMPLT_S_0(1, 0, v2);
+                    ADDx_U12(x4, ed, 16);
+                    ST1W_S(v0, 1, x4);
+                }
+                break;
+            }
             q0 = fpu_get_scratch(dyn, ninst);
             GETVX(v2, 0);
             GETGX(v0, 0);
@@ -595,6 +647,24 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
         case 0x2F:
             INST_NAME("VMASKMOVPD Ex, Gx, Vx");
             nextop = F8;
+            if(arm64_sve && box64_dynarec_sve && !MODREG) {
+                // SVE predicated store: masked out elements are not written, nor read
+                GETVX(v2, 0);
+                GETGX(v0, 0);
+                WILLWRITE2();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 0);
+                PTRUE_D(0, SVE_VL2);
+                CMPLT_D_0(1, 0, v2);
+                ST1D(v0, 1, ed);
+                if(vex.l && !is_avx_zero(dyn, ninst, vex.v)) {
+                    v2 = ymm_get_reg(dyn, ninst, x1, vex.v, 0, gd, -1, -1);
+                    v0 = ymm_get_reg(dyn, ninst, x1, gd, 0, vex.v, -1, -1);
+                    CMPLT_D_0(1, 0, v2);
+                    ADDx_U12(x4, ed, 16);
+                    ST1D(v0, 1, x4);
+                }
+                break;
+            }
             q0 = fpu_get_scratch(dyn, ninst);
             q1 = fpu_get_scratch(dyn, ninst);
             GETVX(v2, 0);
@@ -999,6 +1069,28 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
         case 0x8C:
             INST_NAME("VPMASKMOVD/Q Gx, Vx, Ex");
             nextop = F8;
+            if(arm64_sve && box64_dynarec_sve && !MODREG) {
+                // SVE predicated load: masked out elements are not read, so they can't fault
+                GETGX_empty_VX(v0, v2);
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 0);
+                SMREAD();
+                if(rex.w) {PTRUE_D(0, SVE_VL2);} else {PTRUE_S(0, SVE_VL4);}
+                for(int l=0; l<1+vex.l; ++l) {
+                    if(l) {
+                        GETGY_empty_VY(v0, v2, 0, -1, -1);
+                        ADDx_U12(x4, ed, 16);
+                    }
+                    if(rex.w) {
+                        CMPLT_D_0(1, 0, v2);
+                        LD1D(v0, 1, l?x4:ed);
+                    } else {
+                        CMPLT_S_0(1, 0, v2);
+                        LD1W_S(v0, 1, l?x4:ed);
+                    }
+                }
+                if(!vex.l) YMM0(gd);
+                break;
+            }
             q0 = fpu_get_scratch(dyn, ninst);
             for(int l=0; l<1+vex.l; ++l) {
                 if(MODREG) {
@@ -1064,6 +1156,34 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
         case 0x8E:
             INST_NAME("VPMASKMOVD/Q Ex, Vx, Gx");
             nextop = F8;
+            if(arm64_sve && box64_dynarec_sve && !MODREG) {
+                // SVE predicated store: masked out elements are not written, nor read
+                GETVX(v2, 0);
+                GETGX(v0, 0);
+                WILLWRITE2();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 0);
+                if(rex.w) {PTRUE_D(0, SVE_VL2);} else {PTRUE_S(0, SVE_VL4);}
+                if(rex.w) {
+                    CMPLT_D_0(1, 0, v2);
+                    ST1D(v0, 1, ed);
+                } else {
+                    CMPLT_S_0(1, 0, v2);
+                    ST1W_S(v0, 1, ed);
+                }
+                if(vex.l && !is_avx_zero(dyn, ninst, vex.v)) {
+                    v2 = ymm_get_reg(dyn, ninst, x1, vex.v, 0, gd, -1, -1);
+                    v0 = ymm_get_reg(dyn, ninst, x1, gd, 0, vex.v, -1, -1);
+                    ADDx_U12(x4, ed, 16);
+                    if(rex.w) {
+                        CMPLT_D_0(1, 0, v2);
+                        ST1D(v0, 1, x4);
+                    } else {
+                        CMPLT_S_0(1, 0, v2);
+                        ST1W_S(v0, 1, x4);
+                    }
+                }
+                break;
+            }
             q0 = fpu_get_scratch(dyn, ninst);
             for(int l=0; l<1+vex.l; ++l) {
                 if(!l) {
@@ -97,6 +97,22 @@ void emit_xor32(dynarec_arm_t* dyn, int ninst, rex_t rex, int s1, int s2, int s3
     } else IFX(X_ALL) {
         SET_DFNONE(s4);
     }
+    if(s1==s2) {
+        // xor r, r: result is 0, so all flags are known
+        MOVw_REG(s1, xZR);
+        IFX(X_PEND) {
+            STRxw_U12(xZR, xEmu, offsetof(x64emu_t, res));
+        }
+        IFX(X_CF | X_AF | X_OF | X_SF) {
+            MOV32w(s3, (1<<F_CF)|(1<<F_AF)|(1<<F_OF)|(1<<F_SF));
+            BICw(xFlags, xFlags, s3);
+        }
+        IFX(X_ZF | X_PF) {
+            MOV32w(s3, (1<<F_ZF)|(1<<F_PF));
+            ORRw_REG(xFlags, xFlags, s3);
+        }
+        return;
+    }
     EORxw_REG(s1, s1, s2);
     IFX(X_PEND) {
         STRxw_U12(s1, xEmu, offsetof(x64emu_t, res));
@@ -23,6 +23,7 @@
 #include "dynarec_native.h"
 #include "dynarec_arm64_private.h"
 #include "dynarec_arm64_functions.h"
+#include "arm64_emitter.h"
 #include "custommem.h"
 #include "bridge.h"
 
@@ -469,6 +470,72 @@ int fpuCacheNeedsTransform(dynarec_arm_t* dyn, int ninst) {
     return ret;
 }
 
+static int nativeFlagsOpcode(uintptr_t addr, int is32bits)
+{
+    uint8_t* p = (uint8_t*)addr;
+    if(!is32bits && (p[0]&0xF0)==0x40)
+        ++p;
+    switch(p[0]) {
+        case 0x39:  // CMP Ed, Gd
+        case 0x3B:  // CMP Gd, Ed
+        case 0x3D:  // CMP EAX, Id
+            return NAT_FLAG_OP_SUB;
+        case 0x81:
+        case 0x83:  // CMP Ed, Id/Ib
+            return (((p[1]>>3)&7)==7)?NAT_FLAG_OP_SUB:NAT_FLAG_OP_NONE;
+        case 0x85:  // TEST Ed, Gd
+        case 0xA9:  // TEST EAX, Id
+            return NAT_FLAG_OP_LOGIC;
+    }
+    return NAT_FLAG_OP_NONE;
+}
+
+static int nativeFlagsJcc(uintptr_t addr)
+{
+    uint8_t* p = (uint8_t*)addr;
+    int cond;
+    if(p[0]>=0x70 && p[0]<=0x7F)
+        cond = p[0]&15;
+    else if(p[0]==0x0F && p[1]>=0x80 && p[1]<=0x8F)
+        cond = p[1]&15;
+    else
+        return -1;
+    if(cond==0xA || cond==0xB)
+        return -1;  // PF is not in NZCV
+    return cond;
+}
+
+void updateNativeFlags(dynarec_arm_t* dyn, int is32bits)
+{
+    if(!box64_dynarec_nativeflags || box64_dynarec_test)
+        return;
+    #ifdef HAVE_TRACE
+    if(box64_dynarec_trace)
+        return;
+    #endif
+    for(int i=1; i<dyn->size; ++i) {
+        // the Jcc must only be reached from the CMP/TEST, with nothing emitted in between
+        if(!dyn->insts[i].x64.alive || dyn->insts[i].x64.barrier || dyn->insts[i].pred_sz!=1 || dyn->insts[i].pred[0]!=i-1)
+            continue;
+        if(nativeFlagsJcc(dyn->insts[i].x64.addr)<0)
+            continue;
+        int op = nativeFlagsOpcode(dyn->insts[i-1].x64.addr, is32bits);
+        if(op==NAT_FLAG_OP_NONE)
+            continue;
+        dyn->insts[i-1].nat_flags_op = op;
+        dyn->insts[i].nat_flags_fusion = 1;
+        dyn->insts[i].x64.use_flags = 0;    // so the CMP/TEST only computes the x86 flags needed after the Jcc
+    }
+}
+
+int nativeFlagsCond(dynarec_arm_t* dyn, int ninst, int cond)
+{
+    //                            O    NO   B    NB   Z    NZ   BE   NBE  S    NS   P    NP   L    GE   LE   G
+    static const int sub[16]   = {cVS, cVC, cCC, cCS, cEQ, cNE, cLS, cHI, cMI, cPL, c__, c__, cLT, cGE, cLE, cGT};
+    static const int logic[16] = {cVS, cVC, cCS, cCC, cEQ, cNE, cEQ, cNE, cMI, cPL, c__, c__, cLT, cGE, cLE, cGT};
+    return (dyn->insts[ninst-1].nat_flags_op==NAT_FLAG_OP_LOGIC)?logic[cond&15]:sub[cond&15];
+}
+
 void neoncacheUnwind(neoncache_t* cache)
 {
     if(cache->swapped) {
@@ -691,6 +758,8 @@ void inst_name_pass3(dynarec_native_t* dyn, int ninst, const char* name, rex_t r
             dynarec_log(LOG_NONE, ", jmp=out");
         if(dyn->insts[ninst].x64.has_callret)
             dynarec_log(LOG_NONE, ", callret");
+        if(dyn->insts[ninst].nat_flags_fusion)
+            dynarec_log(LOG_NONE, ", native flags");
         if(dyn->last_ip)
             dynarec_log(LOG_NONE, ", last_ip=%p", (void*)dyn->last_ip);
         for(int ii=0; ii<32; ++ii) {
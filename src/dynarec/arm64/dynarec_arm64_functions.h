@@ -55,6 +55,11 @@ int neoncache_no_i64(dynarec_arm_t* dyn, int ninst, int st, int a);
 // FPU Cache transformation (for loops) // Specific, need to be written by backend
 int fpuCacheNeedsTransform(dynarec_arm_t* dyn, int ninst);
 
+// Mark the CMP/TEST + Jcc pairs where the Jcc can use the native flags (after pass0, before updateNeed)
+void updateNativeFlags(dynarec_arm_t* dyn, int is32bits);
+// Native condition code for the x86 condition cond (0..15) of a fused Jcc
+int nativeFlagsCond(dynarec_arm_t* dyn, int ninst, int cond);
+
 // Undo the changes of a neoncache to get the status before the instruction
 void neoncacheUnwind(neoncache_t* cache);
 
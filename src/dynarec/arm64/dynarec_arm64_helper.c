@@ -85,7 +85,25 @@ uintptr_t geted(dynarec_arm_t* dyn, uintptr_t addr, int ninst, uint8_t nextop, u
             }
         } else if((nextop&7)==5) {
             int64_t tmp = F32S64;
-            if((tmp>=absmin) && (tmp<=absmax) && !(tmp&mask)) {
+            // xRIP holds a known address (last_ip), so the target can often be reached from it without moving xRIP
+            #if STEP > 1
+            int known_ip = (lock!=1) && dyn->last_ip;
+            #else
+            int known_ip = 0;
+            #endif
+            int64_t rel = (int64_t)(tmp+addr+delta-dyn->last_ip);
+            if(known_ip && (rel>=absmin) && (rel<=absmax) && !(rel&mask)) {
+                ret = xRIP;
+                *fixaddress = rel;
+            } else if(known_ip && unscaled && (rel>-256) && (rel<256)) {
+                ret = xRIP;
+                *fixaddress = rel;
+                *unscaled = 1;
+            } else if(known_ip && (rel>0) && (rel<0x1000)) {
+                ADDx_U12(ret, xRIP, rel);
+            } else if(known_ip && (rel<0) && (rel>-0x1000)) {
+                SUBx_U12(ret, xRIP, -rel);
+            } else if((tmp>=absmin) && (tmp<=absmax) && !(tmp&mask)) {
                 GETIP(addr+delta);
                 ret = xRIP;
                 *fixaddress = tmp;
@@ -1080,12 +1098,17 @@ void x87_purgecache(dynarec_arm_t* dyn, int ninst, int next, int s1, int s2, int
             ORRw_mask(s1, s1, 0b010000, 0b001111);  // 0xffff0000
             LSRw_IMM(s1, s1, -a*2);
         }
+        // merge the freed tags in the same update
+        if(dyn->n.tags) {
+            MOV32w(s3, dyn->n.tags);
+            ORRw_REG(s1, s1, s3);
+        }
         STRH_U12(s1, xEmu, offsetof(x64emu_t, fpu_tags));
     } else {
         LDRw_U12(s2, xEmu, offsetof(x64emu_t, top));
     }
     // check if free is used
-    if(dyn->n.tags) {
+    if(dyn->n.tags && !a) {
         LDRH_U12(s1, xEmu, offsetof(x64emu_t, fpu_tags));
         MOV32w(s3, dyn->n.tags);
         ORRw_REG(s1, s1, s3);
@@ -1112,17 +1135,22 @@ void x87_purgecache(dynarec_arm_t* dyn, int ninst, int next, int s1, int s2, int
                     MESSAGE(LOG_DUMP, "Warning, incoherency with purged ST%d cache\n", st);
                 }
                 #endif
-                ADDw_U12(s3, s2, dyn->n.x87cache[i]);   // unadjusted count, as it's relative to real top
-                ANDw_mask(s3, s3, 0, 2); //mask=7   // (emu->top + st)&7
+                // ST0 is at top itself (already in 0..7), no need to compute the index
+                int idx = s2;
+                if(dyn->n.x87cache[i]) {
+                    idx = s3;
+                    ADDw_U12(s3, s2, dyn->n.x87cache[i]);   // unadjusted count, as it's relative to real top
+                    ANDw_mask(s3, s3, 0, 2); //mask=7   // (emu->top + st)&7
+                }
                 switch(neoncache_get_current_st(dyn, ninst, st)) {
                     case NEON_CACHE_ST_D:
-                        VSTR64_REG_LSL3(dyn->n.x87reg[i], s1, s3);    // save the value
+                        VSTR64_REG_LSL3(dyn->n.x87reg[i], s1, idx);    // save the value
                         break;
                     case NEON_CACHE_ST_F:
                         {
                             int scratch = fpu_get_scratch(dyn, ninst);
                             FCVT_D_S(scratch, dyn->n.x87reg[i]);
-                            VSTR64_REG_LSL3(scratch, s1, s3);    // save the value
+                            VSTR64_REG_LSL3(scratch, s1, idx);    // save the value
                             fpu_free_reg(dyn, scratch);
                         }
                         break;
@@ -1130,7 +1158,7 @@ void x87_purgecache(dynarec_arm_t* dyn, int ninst, int next, int s1, int s2, int
                         {
                             int scratch = fpu_get_scratch(dyn, ninst);
                             SCVTFDD(scratch, dyn->n.x87reg[i]);
-                            VSTR64_REG_LSL3(scratch, s1, s3);    // save the value
+                            VSTR64_REG_LSL3(scratch, s1, idx);    // save the value
                             fpu_free_reg(dyn, scratch);
                         }
                         break;
@@ -1204,15 +1232,19 @@ static void x87_reflectcache(dynarec_arm_t* dyn, int ninst, int s1, int s2, int
     // loop all cache entries
     for (int i=0; i<8; ++i)
         if(dyn->n.x87cache[i]!=-1) {
-            ADDw_U12(s3, s2, dyn->n.x87cache[i]);
-            ANDw_mask(s3, s3, 0, 2); // mask=7   // (emu->top + i)&7
+            int idx = s2;
+            if(dyn->n.x87cache[i]) {
+                idx = s3;
+                ADDw_U12(s3, s2, dyn->n.x87cache[i]);
+                ANDw_mask(s3, s3, 0, 2); // mask=7   // (emu->top + i)&7
+            }
             if(neoncache_get_st_f(dyn, ninst, dyn->n.x87cache[i])>=0) {
                 int scratch = fpu_get_scratch(dyn, ninst);
                 FCVT_D_S(scratch, dyn->n.x87reg[i]);
-                VSTR64_REG_LSL3(scratch, s1, s3);
+                VSTR64_REG_LSL3(scratch, s1, idx);
                 fpu_free_reg(dyn, scratch);
             } else
-                VSTR64_REG_LSL3(dyn->n.x87reg[i], s1, s3);
+                VSTR64_REG_LSL3(dyn->n.x87reg[i], s1, idx);
         }
 }
 
@@ -1388,12 +1420,14 @@ void x87_reget_st(dynarec_arm_t* dyn, int ninst, int s1, int s2, int st)
             ADDx_U12(s1, xEmu, offsetof(x64emu_t, x87));
             LDRw_U12(s2, xEmu, offsetof(x64emu_t, top));
             int a = st - dyn->n.x87stack;
-            if(a<0) {
-                SUBw_U12(s2, s2, -a);
-            } else {
-                ADDw_U12(s2, s2, a);
+            if(a) {
+                if(a<0) {
+                    SUBw_U12(s2, s2, -a);
+                } else {
+                    ADDw_U12(s2, s2, a);
+                }
+                ANDw_mask(s2, s2, 0, 2); //mask=7    // (emu->top + i)&7
             }
-            ANDw_mask(s2, s2, 0, 2); //mask=7    // (emu->top + i)&7
             VLDR64_REG_LSL3(dyn->n.x87reg[i], s1, s2);
             MESSAGE(LOG_DUMP, "\t-------x87 Cache for ST%d\n", st);
             // ok
@@ -1412,12 +1446,14 @@ void x87_reget_st(dynarec_arm_t* dyn, int ninst, int s1, int s2, int st)
     ADDx_U12(s1, xEmu, offsetof(x64emu_t, x87));
     LDRw_U12(s2, xEmu, offsetof(x64emu_t, top));
     int a = st - dyn->n.x87stack;
-    if(a<0) {
-        SUBw_U12(s2, s2, -a);
-    } else {
-        ADDw_U12(s2, s2, a);
+    if(a) {
+        if(a<0) {
+            SUBw_U12(s2, s2, -a);
+        } else {
+            ADDw_U12(s2, s2, a);
+        }
+        ANDw_mask(s2, s2, 0, 2); //mask=7    // (emu->top + i)&7
     }
-    ANDw_mask(s2, s2, 0, 2); //mask=7    // (emu->top + i)&7
     VLDR64_REG_LSL3(dyn->n.x87reg[ret], s1, s2);
     MESSAGE(LOG_DUMP, "\t-------x87 Cache for ST%d\n", st);
 }
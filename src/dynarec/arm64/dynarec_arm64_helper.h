@@ -44,30 +44,30 @@
 #define SMREAD()
 #define SMREADLOCK(lock)
 #define SMMIGHTREAD()
-#define WILLWRITE2()   if(box64_dynarec_strongmem>SMWRITE2_MIN) {WILLWRITE();}
-#define SMWRITE2()   if(box64_dynarec_strongmem>SMWRITE2_MIN) {SMWRITE();}
+#define WILLWRITE2()   if(dyn->strongmem>SMWRITE2_MIN) {WILLWRITE();}
+#define SMWRITE2()   if(dyn->strongmem>SMWRITE2_MIN) {SMWRITE();}
 #define SMWRITELOCK(lock)   SMWRITE()
 #define WILLWRITELOCK(lock)
 #define WILLWRITE()
 #define SMMIGHTWRITE()   if(!MODREG) {SMWRITE();}
 #define SMSTART() dyn->smwrite = 0; dyn->smread = 0;
-#define SMEND() if(dyn->smwrite && (box64_dynarec_strongmem>SMFIRST_MIN)) {int i = ninst; while(i>=0 && !dyn->insts[i].will_write) --i; if(i>=0) {dyn->insts[i].last_write = 1;}} dyn->smwrite = 0
+#define SMEND() if(dyn->smwrite && (dyn->strongmem>SMFIRST_MIN)) {int i = ninst; while(i>=0 && !dyn->insts[i].will_write) --i; if(i>=0) {dyn->insts[i].last_write = 1;}} dyn->smwrite = 0
 #define SMDMB()
 #else
 // Sequence of Write will trigger a DMB on "last" write if strongmem is >= 1
 // Block will trigget at 1st and last if strongmem is >= SMFIRST_MIN
 // Read will contribute to trigger a DMB on "first" read if strongmem is >= SMREAD_MIN
 // Opcode will read
-#define SMREAD()    if(dyn->insts[ninst].will_write) {WILLWRITE();} else if(box64_dynarec_strongmem==SMREAD_VAL && !dyn->smread) {DSB_SY(); dyn->smread = 1;}
+#define SMREAD()    if(dyn->insts[ninst].will_write) {WILLWRITE();} else if(dyn->strongmem==SMREAD_VAL && !dyn->smread) {DSB_SY(); dyn->smread = 1;}
 // Opcode will read with option forced lock
 #define SMREADLOCK(lock)    if((lock)) {SMWRITELOCK(lock);} else {SMREAD();}
 // Opcode might read (depend on nextop)
 #define SMMIGHTREAD()   if(!MODREG) {SMREAD();}
 // Opcode has wrote
-#define SMWRITE()   if((box64_dynarec_strongmem>=SMFIRST_MIN) && dyn->smwrite==0 && (box64_dynarec_strongmem!=SMREAD_VAL)) {SMDMB();} if(box64_dynarec_strongmem>SMSEQ_MIN && (box64_dynarec_strongmem!=SMREAD_VAL)) {if(++dyn->smwrite>=SMSEQ_MAX) {SMDMB(); dyn->smwrite=1;}} else dyn->smwrite=1
+#define SMWRITE()   if((dyn->strongmem>=SMFIRST_MIN) && dyn->smwrite==0 && (dyn->strongmem!=SMREAD_VAL)) {SMDMB();} if(dyn->strongmem>SMSEQ_MIN && (dyn->strongmem!=SMREAD_VAL)) {if(++dyn->smwrite>=SMSEQ_MAX) {SMDMB(); dyn->smwrite=1;}} else dyn->smwrite=1
 // Opcode has wrote (strongmem>1 only)
-#define WILLWRITE2()   if(box64_dynarec_strongmem>SMWRITE2_MIN) {WILLWRITE();}
-#define SMWRITE2()   if(box64_dynarec_strongmem>SMWRITE2_MIN) {SMWRITE();}
+#define WILLWRITE2()   if(dyn->strongmem>SMWRITE2_MIN) {WILLWRITE();}
+#define SMWRITE2()   if(dyn->strongmem>SMWRITE2_MIN) {SMWRITE();}
 // Opcode has wrote with option forced lock
 #define SMWRITELOCK(lock)   if(lock) {SMDMB(); dyn->smwrite=1;} else {SMWRITE();}
 // Opcode has wrote with option forced lock
@@ -75,15 +75,18 @@
 // Opcode might have wrote (depend on nextop)
 #define SMMIGHTWRITE()   if(!MODREG) {SMWRITE();}
 // Opcode will write (without reading)
-#define WILLWRITE() if((box64_dynarec_strongmem>=SMFIRST_MIN) && dyn->smwrite==0 && (box64_dynarec_strongmem!=SMREAD_VAL)) {SMDMB();} else if(box64_dynarec_strongmem>=SMFIRST_MIN && dyn->insts[ninst].last_write && (box64_dynarec_strongmem!=SMREAD_VAL)) {SMDMB();} dyn->smwrite=1
+#define WILLWRITE() if((dyn->strongmem>=SMFIRST_MIN) && dyn->smwrite==0 && (dyn->strongmem!=SMREAD_VAL)) {SMDMB();} else if(dyn->strongmem>=SMFIRST_MIN && dyn->insts[ninst].last_write && (dyn->strongmem!=SMREAD_VAL)) {SMDMB();} dyn->smwrite=1
 // Start of sequence
 #define SMSTART()   SMEND()
 // End of sequence
-#define SMEND()     if(dyn->smwrite && box64_dynarec_strongmem && (box64_dynarec_strongmem!=SMREAD_VAL)) {DMB_ISH();} dyn->smwrite=0; dyn->smread=0
+#define SMEND()     if(dyn->smwrite && dyn->strongmem && (dyn->strongmem!=SMREAD_VAL)) {DMB_ISH();} dyn->smwrite=0; dyn->smread=0
 // Force a Data memory barrier (for LOCK: prefix)
-#define SMDMB()     if(box64_dynarec_strongmem){DSB_ISH();}else{DMB_ISH();} dyn->smwrite=0; dyn->smread=0
+#define SMDMB()     if(dyn->strongmem){DSB_ISH();}else{DMB_ISH();} dyn->smwrite=0; dyn->smread=0
 
 #endif
+// Strongmem MOV to/from memory done with Load-Acquire RCpc / Store-Release instead of barriers (address offset only with LRCPC2)
+// only for strongmem level 1, where the release/acquire ordering is enough, and with LSE2 so unaligned access don't fault (sigbus handles the 16bytes crossing)
+#define SMRCPC()    (dyn->strongmem==1 && arm64_lrcpc && arm64_uscat && box64_dynarec_rcpc)
 
 //LOCK_* define
 #define LOCK_LOCK   (int*)1
@@ -886,9 +889,11 @@
 
 #define IFX(A)  if((dyn->insts[ninst].x64.gen_flags&(A)))
 #define IFX2(A, B)  if((dyn->insts[ninst].x64.gen_flags&(A)) B)
-#define IFX_PENDOR0  if((dyn->insts[ninst].x64.gen_flags&(X_PEND) || !dyn->insts[ninst].x64.gen_flags))
+#define IFX_PENDOR0  if((dyn->insts[ninst].x64.gen_flags&(X_PEND) || (!dyn->insts[ninst].x64.gen_flags && !dyn->insts[ninst].nat_flags_op)))
 #define IFXX(A) if((dyn->insts[ninst].x64.gen_flags==(A)))
 #define IFX2X(A, B) if((dyn->insts[ninst].x64.gen_flags==(A) || dyn->insts[ninst].x64.gen_flags==(B) || dyn->insts[ninst].x64.gen_flags==((A)|(B))))
+// condition A, or the native condition for x86 condition C when the Jcc uses the flags of the previous CMP/TEST
+#define NATIVECOND(A, C)    (dyn->insts[ninst].nat_flags_fusion?nativeFlagsCond(dyn, ninst, (C)):(A))
 #define IFXN(A, B)  if((dyn->insts[ninst].x64.gen_flags&(A) && !(dyn->insts[ninst].x64.gen_flags&(B))))
 
 // Generate FCOM with s1 and s2 scratch regs (the VCMP is already done)
@@ -1123,29 +1128,34 @@
 #define GETIP_(A) TABLE64(0, 0)
 #else
 // put value in the Table64 even if not using it for now to avoid difference between Step2 and Step3. Needs to be optimized later...
-#define GETIP(A)                                        \
-    if(dyn->last_ip && ((A)-dyn->last_ip)<0x1000) {     \
-        uint64_t _delta_ip = (A)-dyn->last_ip;          \
-        dyn->last_ip += _delta_ip;                      \
-        if(_delta_ip) {                                 \
-            ADDx_U12(xRIP, xRIP, _delta_ip);            \
-        }                                               \
-    } else {                                            \
-        dyn->last_ip = (A);                             \
-        if(dyn->last_ip<0xffffffff) {                   \
-            MOV64x(xRIP, dyn->last_ip);                 \
-        } else                                          \
-            TABLE64(xRIP, dyn->last_ip);                \
+#define GETIP(A)                                           \
+    if(dyn->last_ip && ((A)-dyn->last_ip)<0x1000) {        \
+        uint64_t _delta_ip = (A)-dyn->last_ip;             \
+        dyn->last_ip += _delta_ip;                         \
+        if(_delta_ip) {                                    \
+            ADDx_U12(xRIP, xRIP, _delta_ip);               \
+        }                                                  \
+    } else if(dyn->last_ip && (dyn->last_ip-(A))<0x1000) { \
+        SUBx_U12(xRIP, xRIP, dyn->last_ip-(A));            \
+        dyn->last_ip = (A);                                \
+    } else {                                               \
+        dyn->last_ip = (A);                                \
+        if(dyn->last_ip<0xffffffff) {                      \
+            MOV64x(xRIP, dyn->last_ip);                    \
+        } else                                             \
+            TABLE64(xRIP, dyn->last_ip);                   \
     }
-#define GETIP_(A)                                       \
-    if(dyn->last_ip && ((A)-dyn->last_ip)<0x1000) {     \
-        uint64_t _delta_ip = (A)-dyn->last_ip;          \
-        if(_delta_ip) {ADDx_U12(xRIP, xRIP, _delta_ip);}\
-    } else {                                            \
-        if((A)<0xffffffff) {                            \
-            MOV64x(xRIP, (A));                          \
-        } else                                          \
-            TABLE64(xRIP, (A));                         \
+#define GETIP_(A)                                          \
+    if(dyn->last_ip && ((A)-dyn->last_ip)<0x1000) {        \
+        uint64_t _delta_ip = (A)-dyn->last_ip;             \
+        if(_delta_ip) {ADDx_U12(xRIP, xRIP, _delta_ip);}   \
+    } else if(dyn->last_ip && (dyn->last_ip-(A))<0x1000) { \
+        SUBx_U12(xRIP, xRIP, dyn->last_ip-(A));            \
+    } else {                                               \
+        if((A)<0xffffffff) {                               \
+            MOV64x(xRIP, (A));                             \
+        } else                                             \
+            TABLE64(xRIP, (A));                            \
     }
 #endif
 #define CLEARIP()   dyn->last_ip=0
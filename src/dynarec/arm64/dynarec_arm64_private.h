@@ -9,6 +9,10 @@ typedef struct instsize_s instsize_t;
 
 #define BARRIER_MAYBE   8
 
+#define NAT_FLAG_OP_NONE    0
+#define NAT_FLAG_OP_SUB     1   // native flags from a SUBS: C is the inverted x86 CF
+#define NAT_FLAG_OP_LOGIC   2   // native flags from an ANDS: C and V are cleared, as x86 CF and OF
+
 #define NEON_CACHE_NONE     0
 #define NEON_CACHE_ST_D     1
 #define NEON_CACHE_ST_F     2
@@ -94,6 +98,8 @@ typedef struct instruction_arm64_s {
     uint8_t             barrier_maybe;
     uint8_t             will_write;
     uint8_t             last_write;
+    uint8_t             nat_flags_op;       // NAT_FLAG_OP_xxx: the opcode leaves the x86 flags in native NZCV for the next one
+    uint8_t             nat_flags_fusion;   // the opcode (a Jcc) uses the native NZCV of the previous opcode
     flagcache_t         f_exit;     // flags status at end of instruction
     neoncache_t         n;          // neoncache at end of instruction (but before poping)
     flagcache_t         f_entry;    // flags status before the instruction begin
@@ -130,9 +136,11 @@ typedef struct dynarec_arm_s {
     uintptr_t           forward_to; // address of the next jump to (to check if everything is ok)
     int32_t             forward_size;   // size at the forward point
     int                 forward_ninst;  // ninst at the forward point
+    uintptr_t           peek_end;   // end of the code checked after the block (for flags liveness)
     uint16_t            ymm_zero;   // bitmap of ymm to zero at purge
     uint8_t             smwrite;    // for strongmem model emulation
     uint8_t             smread;
+    uint8_t             strongmem;  // strongmem level used for this block
     uint8_t             doublepush;
     uint8_t             doublepop;
     uint8_t             always_test;
@@ -27,6 +27,7 @@
 #include "custommem.h"
 #include "khash.h"
 #include "rbtree.h"
+#include "perfmap.h"
 
 #ifdef CS2
 #include <cs2c.h>
@@ -173,6 +174,27 @@ int FreeRangeDynablock(dynablock_t* db, uintptr_t addr, uintptr_t size)
     return 1;
 }
 
+int isStrongMemRange(uintptr_t addr, uintptr_t size)
+{
+    uint32_t val;
+    uintptr_t end;
+    if(rb_get_end(my_context->db_strongmem, addr, &val, &end))
+        return val;
+    return end<addr+size;
+}
+
+void addStrongMemPage(uintptr_t addr)
+{
+    // plain stores around a LOCK opcode are usually what other threads will read once the lock is taken,
+    // so the whole code page gets the strongmem treatment. Blocks already built there are marked, to be rebuilt
+    uintptr_t page = addr&~(box64_pagesize-1);
+    if(rb_get(my_context->db_strongmem, page))
+        return;
+    dynarec_log(LOG_INFO, "Strongmem enabled for x64 code page %p\n", (void*)page);
+    rb_set(my_context->db_strongmem, page, page+box64_pagesize, 1);
+    cleanDBFromAddressRange(page, box64_pagesize, 0);
+}
+
 dynablock_t *AddNewDynablock(uintptr_t addr)
 {
     dynablock_t* block;
@@ -311,6 +333,8 @@ fill_block_retry:
                 }
                 block->done = 1;    // don't validate the block if the size is null, but keep the block
                 rb_set(my_context->db_sizes, block->x64_size, block->x64_size+1, rb_get(my_context->db_sizes, block->x64_size)+1);
+                if(box64_dynarec_perf_map)
+                    writePerfMap((uintptr_t)block->x64_addr, block->block, DynablockNativeSize(block));
             }
         }
     }
@@ -332,9 +356,11 @@ dynablock_t* DBGetBlock(x64emu_t* emu, uintptr_t addr, int create, int is32bits)
             sched_yield();  // just calm down...
         uint32_t hash = X31_hash_code(db->x64_addr, db->x64_size);
         int need_lock = mutex_trylock(&my_context->mutex_dyndump);
-        if(hash!=db->hash) {
+        // a weak block on a page that has been promoted to strongmem is rebuilt too (the strongmem tree needs the lock)
+        int need_strongmem = !need_lock && box64_dynarec_strongmem_auto && !box64_dynarec_strongmem && !db->strongmem && isStrongMemRange((uintptr_t)db->x64_addr, db->x64_size);
+        if(hash!=db->hash || need_strongmem) {
             db->done = 0;   // invalidating the block
-            dynarec_log(LOG_DEBUG, "Invalidating block %p from %p:%p (hash:%X/%X, always_test:%d) for %p\n", db, db->x64_addr, db->x64_addr+db->x64_size-1, hash, db->hash, db->always_test,(void*)addr);
+            dynarec_log(LOG_DEBUG, "Invalidating block %p from %p:%p (hash:%X/%X, always_test:%d, need_strongmem:%d) for %p\n", db, db->x64_addr, db->x64_addr+db->x64_size-1, hash, db->hash, db->always_test, need_strongmem, (void*)addr);
             // Free db, it's now invalid!
             dynablock_t* old = InvalidDynablock(db, need_lock);
             // start again... (will create a new block)
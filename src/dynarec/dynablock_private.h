@@ -18,9 +18,13 @@ typedef struct dynablock_s {
     uint8_t         gone;
     uint8_t         always_test;
     uint8_t         dirty;      // if need to be tested as soon as it's created
+    uint8_t         strongmem;  // strongmem level the block has been built with
     int             isize;
     instsize_t*     instsize;
     void*           jmpnext;    // a branch jmpnext code when block is marked
 } dynablock_t;
 
+// size of the native code (and table64) of a block, i.e. everything before the jmpnext part
+#define DynablockNativeSize(db) ((uintptr_t)(db)->jmpnext - sizeof(void*) - (uintptr_t)(db)->block)
+
 #endif //__DYNABLOCK_PRIVATE_H_
\ No newline at end of file
@@ -12,6 +12,8 @@
 #define OTHER_CACHE()   \
     if (fpuCacheNeedsTransform(dyn, ninst)) ret|=2;
 
+#define UPDATE_NATIVE_FLAGS(dyn, is32bits)  updateNativeFlags(dyn, is32bits)
+
 #include "arm64/arm64_printer.h"
 #include "arm64/dynarec_arm64_private.h"
 #include "arm64/dynarec_arm64_functions.h"
@@ -28,6 +30,8 @@
 #define OTHER_CACHE() \
     if (fpuCacheNeedsTransform(dyn, ninst)) ret |= 2;
 
+#define UPDATE_NATIVE_FLAGS(dyn, is32bits)
+
 #include "la64/la64_printer.h"
 #include "la64/dynarec_la64_private.h"
 #include "la64/dynarec_la64_functions.h"
@@ -46,6 +50,8 @@
     if (fpuCacheNeedsTransform(dyn, ninst)) ret |= 2; \
     if (sewNeedsTransform(dyn, ninst)) ret |= 4;
 
+#define UPDATE_NATIVE_FLAGS(dyn, is32bits)
+
 #include "rv64/rv64_printer.h"
 #include "rv64/dynarec_rv64_private.h"
 #include "rv64/dynarec_rv64_functions.h"
@@ -18,6 +18,7 @@
 #include "dynablock.h"
 #include "dynablock_private.h"
 #include "elfloader.h"
+#include "perfmap.h"
 
 #include "dynarec_native.h"
 #include "dynarec_arch.h"
@@ -367,6 +368,190 @@ static void fillPredecessors(dynarec_native_t* dyn)
     }
 }
 
+// Store to load forwarding: find the "MOV Gd, Ed" loads of a memory operand written earlier in the block by a
+// "MOV Ed, Gd" of the same size, with the source register unchanged since. Only a few common opcodes are decoded,
+// anything else (or a jump point) ends the tracking. Reading our own store is valid with the x86 memory model regarding
+// other threads, but a write done by a signal handler running between the store and the load is missed (so it's opt-in).
+#define MAX_FWD 8
+typedef struct fwd_mem_s {
+    int     base;   // x64 reg, -1 for none, -2 for an absolute address
+    int     index;  // x64 reg, -1 for none
+    int     scale;
+    int64_t disp;
+    int     size;
+    int     src;    // x64 reg holding the value
+} fwd_mem_t;
+
+static int fwdGetMem(uint8_t* p, uint8_t rex, uintptr_t next, fwd_mem_t* m)
+{
+    // decode a ModRM memory operand, returns 0 if not supported
+    uint8_t nextop = p[0];
+    int mod = nextop>>6;
+    int rm = nextop&7;
+    m->base = -1;
+    m->index = -1;
+    m->scale = 0;
+    m->disp = 0;
+    p++;
+    if(rm==4) {
+        uint8_t sib = *(p++);
+        int idx = ((sib>>3)&7)+((rex&2)?8:0);
+        if(idx!=4) {
+            m->index = idx;
+            m->scale = sib>>6;
+        }
+        if(mod==0 && (sib&7)==5) {
+            m->disp = *(int32_t*)p;
+            return 1;
+        }
+        m->base = (sib&7)+((rex&1)?8:0);
+    } else if(mod==0 && rm==5) {
+        m->base = -2;
+        m->disp = next + *(int32_t*)p;
+        return 1;
+    } else
+        m->base = rm+((rex&1)?8:0);
+    if(mod==1)
+        m->disp = *(int8_t*)p;
+    else if(mod==2)
+        m->disp = *(int32_t*)p;
+    return 1;
+}
+
+static int fwdSameAddr(fwd_mem_t* a, fwd_mem_t* b)
+{
+    return a->base==b->base && a->index==b->index && a->scale==b->scale;
+}
+
+static int fwdKillReg(fwd_mem_t* t, int n, int reg)
+{
+    for(int i=0; i<n; ++i)
+        if(t[i].base==reg || t[i].index==reg || t[i].src==reg)
+            t[i--] = t[--n];
+    return n;
+}
+
+static int fwdKillMem(fwd_mem_t* t, int n, fwd_mem_t* m, int size)
+{
+    // remove everything a write of size bytes at m could overlap
+    for(int i=0; i<n; ++i)
+        if(!fwdSameAddr(&t[i], m) || (t[i].disp<m->disp+size && m->disp<t[i].disp+t[i].size))
+            t[i--] = t[--n];
+    return n;
+}
+
+static void forwardStores(dynarec_native_t* dyn, int is32bits)
+{
+    if(!box64_dynarec_storefwd || box64_dynarec_test || is32bits)
+        return;
+    fwd_mem_t t[MAX_FWD];
+    fwd_mem_t m;
+    int n = 0;
+    for(int i=0; i<dyn->size; ++i) {
+        if(!dyn->insts[i].x64.alive || (i && (dyn->insts[i].pred_sz!=1 || dyn->insts[i].pred[0]!=i-1 || dyn->insts[i-1].x64.barrier)))
+            n = 0;
+        uint8_t* p = (uint8_t*)dyn->insts[i].x64.addr;
+        uintptr_t next = dyn->insts[i].x64.addr + dyn->insts[i].x64.size;
+        uint8_t rex = 0;
+        if((*p&0xf0)==0x40)
+            rex = *(p++);
+        int w = (rex&8)?8:4;
+        uint8_t op = *(p++);
+        uint8_t nextop = *p;
+        int reg = ((nextop>>3)&7)+((rex&4)?8:0);
+        int rm = (nextop&7)+((rex&1)?8:0);
+        int modreg = ((nextop&0xC0)==0xC0);
+        switch(op) {
+            case 0x89:  // MOV Ed, Gd
+                if(modreg)
+                    n = fwdKillReg(t, n, rm);
+                else {
+                    fwdGetMem(p, rex, next, &m);
+                    n = fwdKillMem(t, n, &m, w);
+                    if(n==MAX_FWD)
+                        t[0] = t[--n];
+                    m.size = w;
+                    m.src = reg;
+                    t[n++] = m;
+                }
+                break;
+            case 0x8B:  // MOV Gd, Ed
+                if(!modreg) {
+                    fwdGetMem(p, rex, next, &m);
+                    for(int j=0; j<n; ++j)
+                        if(fwdSameAddr(&t[j], &m) && t[j].disp==m.disp && t[j].size==w) {
+                            dyn->insts[i].x64.fwd_reg = 1+t[j].src;
+                            break;
+                        }
+                }
+                n = fwdKillReg(t, n, reg);
+                break;
+            case 0x01: case 0x09: case 0x11: case 0x19: case 0x21: case 0x29: case 0x31:    // OP Ed, Gd
+                if(modreg)
+                    n = fwdKillReg(t, n, rm);
+                else {
+                    fwdGetMem(p, rex, next, &m);
+                    n = fwdKillMem(t, n, &m, w);
+                }
+                break;
+            case 0x81:
+            case 0x83:
+            case 0xC7:
+                if(op==0xC7 && (nextop&0x38))
+                    n = 0;
+                else if(op!=0xC7 && ((nextop>>3)&7)==7)
+                    ;   // CMP Ed, Ib/Id
+                else if(modreg)
+                    n = fwdKillReg(t, n, rm);
+                else {
+                    fwdGetMem(p, rex, next, &m);
+                    n = fwdKillMem(t, n, &m, w);
+                }
+                break;
+            case 0x88:  // MOV Eb, Gb
+            case 0xC6:  // MOV Eb, Ib
+                if(modreg || (op==0xC6 && (nextop&0x38)))
+                    n = 0;
+                else {
+                    fwdGetMem(p, rex, next, &m);
+                    n = fwdKillMem(t, n, &m, 1);
+                }
+                break;
+            case 0x8A:  // MOV Gb, Eb (AH..BH without REX)
+                n = fwdKillReg(t, n, reg);
+                n = fwdKillReg(t, n, reg&3);
+                break;
+            case 0x03: case 0x0B: case 0x13: case 0x1B: case 0x23: case 0x2B: case 0x33:    // OP Gd, Ed
+            case 0x63:  // MOVSXD
+            case 0x8D:  // LEA
+                n = fwdKillReg(t, n, reg);
+                break;
+            case 0x38: case 0x39: case 0x3A: case 0x3B: case 0x84: case 0x85:   // CMP/TEST
+                break;
+            case 0xB8: case 0xB9: case 0xBA: case 0xBB: case 0xBC: case 0xBD: case 0xBE: case 0xBF:
+                n = fwdKillReg(t, n, (op&7)+((rex&1)?8:0));
+                break;
+            case 0x90:
+                if(rex&1)
+                    n = 0;
+                break;
+            case 0x0F:
+                op = *(p++);
+                nextop = *p;
+                reg = ((nextop>>3)&7)+((rex&4)?8:0);
+                if(op==0xAF || op==0xB6 || op==0xB7 || op==0xBE || op==0xBF)   // IMUL, MOVZX, MOVSX
+                    n = fwdKillReg(t, n, reg);
+                else if(op!=0x1F)   // NOP
+                    n = 0;
+                break;
+            default:
+                // prefixes and everything else
+                n = 0;
+        }
+    }
+}
+#undef MAX_FWD
+
 // updateNeed for the current block. recursive function that goes backward
 static int updateNeed(dynarec_native_t* dyn, int ninst, uint8_t need) {
     while (ninst>=0) {
@@ -761,6 +946,7 @@ void* FillBlock64(
     helper.next_cap = MAX_INSTS;
     helper.table64 = static_table64;
     helper.table64cap = sizeof(static_table64)/sizeof(uint64_t);
+    helper.strongmem = box64_dynarec_strongmem;
     // pass 0, addresses, x64 jump addresses, overall size of the block
     uintptr_t end = native_pass0(&helper, addr, alternate, is32bits);
     if(helper.abort) {
@@ -784,6 +970,9 @@ void* FillBlock64(
         protectDB(addr, end-addr);  //end is 1byte after actual end
     // compute hash signature
     uint32_t hash = X31_hash_code((void*)addr, end-addr);
+    // pass 0 has marked the pages with LOCK opcodes, pass 1 to 3 need the final strongmem level
+    if(box64_dynarec_strongmem_auto && !helper.strongmem && isStrongMemRange(addr, end-addr))
+        helper.strongmem = 1;
     // calculate barriers
     for(int ii=0; ii<helper.jmp_sz; ++ii) {
         int i = helper.jmps[ii];
@@ -792,7 +981,12 @@ void* FillBlock64(
         if(j<start || j>=end || j==helper.insts[i].x64.addr) {
             if(j==helper.insts[i].x64.addr) // if there is a loop on some opcode, make the block "always to tested"
                 helper.always_test = 1;
-            helper.insts[i].x64.need_after |= X_PEND;
+            uintptr_t next = (j>=end && j-end<MAX_PEEK)?flagsDeadAt(j, is32bits):0;
+            if(next && next-end<=MAX_PEEK) {
+                if(next>helper.peek_end)
+                    helper.peek_end = next;
+            } else
+                helper.insts[i].x64.need_after |= X_PEND;
         } else {
             // find jump address instruction
             int k=-1;
@@ -831,6 +1025,12 @@ void* FillBlock64(
             }
         }
     }
+    // the block depends on the code checked for flags liveness after its end
+    if(helper.peek_end>end) {
+        end = helper.peek_end;
+        protectDB(addr, end-addr);
+        hash = X31_hash_code((void*)addr, end-addr);
+    }
     // no need for next anymore
     helper.next_sz = helper.next_cap = 0;
     helper.next = NULL;
@@ -838,6 +1038,9 @@ void* FillBlock64(
     int alloc_size = sizePredecessors(&helper);
     helper.predecessor = (int*)alloca(alloc_size*sizeof(int));
     fillPredecessors(&helper);
+    UPDATE_NATIVE_FLAGS(&helper, is32bits);
+    forwardStores(&helper, is32bits);
+    markInlineSyscalls(&helper, is32bits);
 
     int pos = helper.size;
     while (pos>=0)
@@ -1012,6 +1215,7 @@ void* FillBlock64(
         block->hash = hash;
         block->always_test = host_meta->block_always_test;
         block->dirty = host_meta->block_dirty;
+        block->strongmem = helper.strongmem;
         block->isize = host_meta->block_isize;
         block->instsize = instsize;
         block->jmpnext = next + sizeof(void*);
@@ -1163,6 +1367,7 @@ slow_path:
     block->jmpnext = next+sizeof(void*);
     block->always_test = helper.always_test;
     block->dirty = block->always_test;
+    block->strongmem = helper.strongmem;
 #ifdef CS2
     if (cs2c_with_fast_path) {
         host_metadata.native_size = native_size;
@@ -1369,6 +1574,8 @@ void PreloadBlock64(void* data, const CacheTableDataRaw* cs2_block)
                 }
                 block->done = 1; // don't validate the block if the size is null, but keep the block
                 rb_set(my_context->db_sizes, block->x64_size, block->x64_size + 1, rb_get(my_context->db_sizes, block->x64_size) + 1);
+                if (box64_dynarec_perf_map)
+                    writePerfMap((uintptr_t)block->x64_addr, block->block, DynablockNativeSize(block));
             }
         }
         // Finally, adjust start/end address in context
@@ -1417,6 +1624,7 @@ void* PreloadFillBlock64(
     helper.next_cap = MAX_INSTS;
     helper.table64 = static_table64;
     helper.table64cap = sizeof(static_table64)/sizeof(uint64_t);
+    helper.strongmem = box64_dynarec_strongmem;
     // pass 0, addresses, x64 jump addresses, overall size of the block
     uintptr_t end = native_pass0(&helper, addr, alternate, is32bits);
     if(helper.abort) {
@@ -1440,6 +1648,9 @@ void* PreloadFillBlock64(
         protectDB(addr, end-addr);  //end is 1byte after actual end
     // compute hash signature
     uint32_t hash = X31_hash_code((void*)addr, end-addr);
+    // pass 0 has marked the pages with LOCK opcodes, pass 1 to 3 need the final strongmem level
+    if(box64_dynarec_strongmem_auto && !helper.strongmem && isStrongMemRange(addr, end-addr))
+        helper.strongmem = 1;
     // calculate barriers
     for(int ii=0; ii<helper.jmp_sz; ++ii) {
         int i = helper.jmps[ii];
@@ -1448,7 +1659,12 @@ void* PreloadFillBlock64(
         if(j<start || j>=end || j==helper.insts[i].x64.addr) {
             if(j==helper.insts[i].x64.addr) // if there is a loop on some opcode, make the block "always to tested"
                 helper.always_test = 1;
-            helper.insts[i].x64.need_after |= X_PEND;
+            uintptr_t next = (j>=end && j-end<MAX_PEEK)?flagsDeadAt(j, is32bits):0;
+            if(next && next-end<=MAX_PEEK) {
+                if(next>helper.peek_end)
+                    helper.peek_end = next;
+            } else
+                helper.insts[i].x64.need_after |= X_PEND;
         } else {
             // find jump address instruction
             int k=-1;
@@ -1487,6 +1703,12 @@ void* PreloadFillBlock64(
             }
         }
     }
+    // the block depends on the code checked for flags liveness after its end
+    if(helper.peek_end>end) {
+        end = helper.peek_end;
+        protectDB(addr, end-addr);
+        hash = X31_hash_code((void*)addr, end-addr);
+    }
     // no need for next anymore
     helper.next_sz = helper.next_cap = 0;
     helper.next = NULL;
@@ -1494,6 +1716,9 @@ void* PreloadFillBlock64(
     int alloc_size = sizePredecessors(&helper);
     helper.predecessor = (int*)alloca(alloc_size*sizeof(int));
     fillPredecessors(&helper);
+    UPDATE_NATIVE_FLAGS(&helper, is32bits);
+    forwardStores(&helper, is32bits);
+    markInlineSyscalls(&helper, is32bits);
 
     int pos = helper.size;
     while (pos>=0)
@@ -1591,6 +1816,7 @@ void* PreloadFillBlock64(
     block->hash = hash;
     block->always_test = host_meta->block_always_test;
     block->dirty = host_meta->block_dirty;
+    block->strongmem = helper.strongmem;
     block->isize = host_meta->block_isize;
     block->instsize = next + 4 * sizeof(void*);
     block->jmpnext = next + sizeof(void*);
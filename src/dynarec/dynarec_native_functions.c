@@ -7,6 +7,7 @@
 #include <signal.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <sys/mman.h>
 
 #include "debug.h"
 #include "box64context.h"
@@ -619,6 +620,146 @@ int isNativeCall(dynarec_native_t* dyn, uintptr_t addr, uintptr_t* calladdress,
 #undef PK
 }
 
+void markInlineSyscalls(dynarec_native_t* dyn, int is32bits)
+{
+    // only the "mov eax, imm32; syscall" sequence, with no other path to the syscall in the block
+    // done once after the predecessors are filled, so passes 1 to 3 agree on it (pass0 sees a regular SYSCALL, that is a superset)
+    if(!box64_dynarec_syscall || is32bits || box64_log>=LOG_DEBUG || cycle_log)
+        return;
+    for(int ninst=1; ninst<dyn->size; ++ninst) {
+        uintptr_t addr = dyn->insts[ninst].x64.addr;
+        if(dyn->insts[ninst].x64.size!=2 || *(uint8_t*)addr!=0x0F || *(uint8_t*)(addr+1)!=0x05)
+            continue;
+        if(dyn->insts[ninst].pred_sz!=1 || dyn->insts[ninst].pred[0]!=ninst-1)
+            continue;
+        uintptr_t prev = dyn->insts[ninst-1].x64.addr;
+        if(!prev || dyn->insts[ninst-1].x64.size!=5 || *(uint8_t*)prev!=0xB8)
+            continue;
+        int nbpars = 0;
+        int nats = GetNativeSyscall(*(uint32_t*)(prev+1), &nbpars);
+        if(nats) {
+            dyn->insts[ninst].x64.syscall_nats = nats;
+            dyn->insts[ninst].x64.syscall_pars = nbpars;
+        }
+    }
+}
+
+int isInlineSyscall(dynarec_native_t* dyn, int ninst, int* nbpars)
+{
+    if(nbpars) *nbpars = dyn->insts[ninst].x64.syscall_pars;
+    return dyn->insts[ninst].x64.syscall_nats;
+}
+
+int isLockedOpcode(dynarec_native_t* dyn, uintptr_t addr, int is32bits)
+{
+    (void)dyn;
+
+#define PK(a)       *(uint8_t*)(addr+a)
+
+    // legacy prefixes, in any order
+    for(int i=0; i<14; ++i, ++addr) {
+        uint8_t p = PK(0);
+        if(p==0xF0)
+            return 1;
+        if(p!=0x66 && p!=0x67 && p!=0xF2 && p!=0xF3 && p!=0x26 && p!=0x2E && p!=0x36 && p!=0x3E && p!=0x64 && p!=0x65)
+            break;
+    }
+    if(!is32bits && (PK(0)&0xF0)==0x40)
+        ++addr;
+    // XCHG with a memory operand is implicitly locked
+    if((PK(0)==0x86 || PK(0)==0x87) && ((PK(1)&0xC0)!=0xC0))
+        return 1;
+    return 0;
+#undef PK
+}
+
+static int readableCode(uintptr_t addr)
+{
+    return (getProtection(addr)&PROT_READ) && (getProtection(addr+15)&PROT_READ);
+}
+
+uintptr_t flagsDeadAt(uintptr_t addr, int is32bits)
+{
+#define PK(a)       *(uint8_t*)(addr+a)
+
+    if(box64_dynarec_test || !box64_dynarec_deadflags)
+        return 0;
+    // only a few simple opcodes are followed: mov/lea/push/pop/nop, until an opcode that set all the flags
+    for(int n=0; n<8; ++n) {
+        if(!readableCode(addr))
+            return 0;
+        int opsz = 4;
+        int rexw = 0;
+        while(PK(0)==0x66 || PK(0)==0x2E || PK(0)==0x3E || PK(0)==0x64 || PK(0)==0x65) {
+            if(PK(0)==0x66) opsz = 2;
+            ++addr;
+        }
+        if(!is32bits && (PK(0)&0xF0)==0x40) {
+            rexw = (PK(0)>>3)&1;
+            ++addr;
+        }
+        uint8_t op = PK(0);
+        int modrm = 0;
+        int imm = 0;
+        int setflags = 0;
+        if(op<0x40 && (op&7)<6 && ((op>>3)&7)!=2 && ((op>>3)&7)!=3) {
+            // ADD/OR/AND/SUB/XOR/CMP
+            setflags = 1;
+            modrm = (op&7)<4;
+            imm = ((op&7)==4)?1:(((op&7)==5)?opsz:0);
+        } else if(op==0x84 || op==0x85) {
+            setflags = modrm = 1;
+        } else if(op==0xA8 || op==0xA9) {
+            setflags = 1;
+            imm = (op==0xA8)?1:opsz;
+        } else if(op>=0x80 && op<=0x83 && op!=0x82) {
+            if(((PK(1)>>3)&7)==2 || ((PK(1)>>3)&7)==3)
+                return 0;   // ADC/SBB read CF
+            setflags = modrm = 1;
+            imm = (op==0x81)?opsz:1;
+        } else if(op>=0x88 && op<=0x8B) {
+            modrm = 1;
+        } else if(op==0x8D) {
+            modrm = 1;
+        } else if(op==0xC6 || op==0xC7) {
+            if((PK(1)>>3)&7)
+                return 0;
+            modrm = 1;
+            imm = (op==0xC6)?1:opsz;
+        } else if(op>=0xB0 && op<=0xB7) {
+            imm = 1;
+        } else if(op>=0xB8 && op<=0xBF) {
+            imm = rexw?8:opsz;
+        } else if((op>=0x50 && op<=0x5F) || op==0x90) {
+        } else if(op==0x0F && PK(1)==0x1F) {
+            ++addr;
+            modrm = 1;
+        } else
+            return 0;
+        ++addr;
+        if(modrm) {
+            uint8_t m = PK(0);
+            ++addr;
+            if((m&0xC0)!=0xC0) {
+                if((m&7)==4) {
+                    if((m&0xC0)==0 && (PK(0)&7)==5)
+                        addr+=4;
+                    ++addr;
+                }
+                if((m&0xC0)==0x40)
+                    addr+=1;
+                else if((m&0xC0)==0x80 || (m&0xC7)==0x05)
+                    addr+=4;
+            }
+        }
+        addr+=imm;
+        if(setflags)
+            return addr;
+    }
+    return 0;
+#undef PK
+}
+
 // AVX
 void avx_mark_zero(dynarec_native_t* dyn, int ninst, int reg)
 {
@@ -73,6 +73,14 @@ uint8_t geted_ib(dynarec_native_t* dyn, uintptr_t addr, int ninst, uint8_t nexto
 
 // Is what pointed at addr a native call? And if yes, to what function?
 int isNativeCall(dynarec_native_t* dyn, uintptr_t addr, uintptr_t* calladdress, uint16_t* retn);
+// Mark the SYSCALL that can be inlined, once the predecessors are filled
+void markInlineSyscalls(dynarec_native_t* dyn, int is32bits);
+// Is the SYSCALL at ninst a known pass-through syscall? Return the native syscall number (0 if not)
+int isInlineSyscall(dynarec_native_t* dyn, int ninst, int* nbpars);
+// Is the opcode at addr a LOCK prefixed one (or an implicitly locked XCHG)?
+int isLockedOpcode(dynarec_native_t* dyn, uintptr_t addr, int is32bits);
+// Are all the flags set by the code at addr before being read? Return the end of the checked code, 0 if not (or unknown)
+uintptr_t flagsDeadAt(uintptr_t addr, int is32bits);
 
 // AVX utilities
 void avx_mark_zero(dynarec_native_t* dyn, int ninst, int reg);
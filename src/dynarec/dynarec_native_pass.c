@@ -110,6 +110,10 @@ uintptr_t native_pass(dynarec_native_t* dyn, uintptr_t addr, int alternate, int
             dyn->last_ip = 0;   // reset IP if some jump are coming here
         #endif
         dyn->f.dfnone_here = 0;
+        #if STEP == 0
+        if(box64_dynarec_strongmem_auto && !box64_dynarec_strongmem && isLockedOpcode(dyn, addr, is32bits))
+            addStrongMemPage(addr);
+        #endif
         NEW_INST;
         MESSAGE(LOG_DUMP, "New Instruction %s:%p, native:%p\n", is32bits?"x86":"x64",(void*)addr, (void*)dyn->block);
         if(!ninst) {
@@ -337,7 +341,11 @@ uintptr_t native_pass(dynarec_native_t* dyn, uintptr_t addr, int alternate, int
                 BARRIER(BARRIER_FLOAT);
             }
             #if STEP == 0
-            dyn->insts[ninst].x64.need_after |= X_PEND;
+            uintptr_t next = flagsDeadAt(addr, rex.is32bits);
+            if(next && next-addr<=MAX_PEEK)
+                dyn->peek_end = next;
+            else
+                dyn->insts[ninst].x64.need_after |= X_PEND;
             #endif
             ++ninst;
             NOTEST(x3);
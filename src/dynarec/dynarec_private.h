@@ -46,6 +46,9 @@ typedef struct instruction_x64_s {
     uint8_t     gen_flags;  // calculated
     uint8_t     need_before;// calculated
     uint8_t     need_after; // calculated
+    uint8_t     fwd_reg;    // for a MOV Gd, Ed load: 1+x64 reg that still holds the value stored there earlier in the block, 0 if none
+    uint8_t     syscall_pars;   // for an inlined SYSCALL: number of parameters
+    uint16_t    syscall_nats;   // for an inlined SYSCALL: native syscall number, 0 if not inlined
 } instruction_x64_t;
 
 void printf_x64_instruction(zydis_dec_t* dec, instruction_x64_t* inst, const char* name);
@@ -0,0 +1,429 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "la64_emitter.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+
+#include "la64_printer.h"
+#include "dynarec_la64_private.h"
+#include "dynarec_la64_functions.h"
+#include "dynarec_la64_helper.h"
+
+uintptr_t dynarec64_AVX_66_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)need_epilog;
+
+    uint8_t opcode = F8;
+    uint8_t nextop;
+    uint8_t gd, ed;
+    int v0, v1, v2;
+    int q0;
+    int64_t fixedaddress;
+    rex_t rex = vex.rex;
+
+    MAYUSE(v2);
+    MAYUSE(q0);
+
+    switch (opcode) {
+        case 0x10:
+            INST_NAME("VMOVUPD Gx, Ex");
+            nextop = F8;
+            GETG;
+            if (MODREG) {
+                ed = (nextop & 7) + (rex.b << 3);
+                v1 = sse_get_reg(dyn, ninst, x1, ed, 0);
+                v0 = sse_get_reg_empty(dyn, ninst, x1, gd);
+                VOR_V(v0, v1, v1);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[ed]));
+                    PUTGY(q0);
+                }
+            } else {
+                v0 = sse_get_reg_empty(dyn, ninst, x1, gd);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 16, 0);
+                VLD(v0, ed, fixedaddress);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, ed, fixedaddress + 16);
+                    PUTGY(q0);
+                }
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x11:
+            INST_NAME("VMOVUPD Ex, Gx");
+            nextop = F8;
+            GETG;
+            v0 = sse_get_reg(dyn, ninst, x1, gd, 0);
+            if (MODREG) {
+                ed = (nextop & 7) + (rex.b << 3);
+                v1 = sse_get_reg_empty(dyn, ninst, x1, ed);
+                VOR_V(v1, v0, v0);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[gd]));
+                    VST(q0, xEmu, offsetof(x64emu_t, ymm[ed]));
+                } else {
+                    YMM0(ed);
+                }
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 16, 0);
+                VST(v0, ed, fixedaddress);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[gd]));
+                    VST(q0, ed, fixedaddress + 16);
+                }
+                SMWRITE2();
+            }
+            break;
+        case 0x28:
+            INST_NAME("VMOVAPD Gx, Ex");
+            nextop = F8;
+            GETG;
+            if (MODREG) {
+                ed = (nextop & 7) + (rex.b << 3);
+                v1 = sse_get_reg(dyn, ninst, x1, ed, 0);
+                v0 = sse_get_reg_empty(dyn, ninst, x1, gd);
+                VOR_V(v0, v1, v1);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[ed]));
+                    PUTGY(q0);
+                }
+            } else {
+                v0 = sse_get_reg_empty(dyn, ninst, x1, gd);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 16, 0);
+                VLD(v0, ed, fixedaddress);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, ed, fixedaddress + 16);
+                    PUTGY(q0);
+                }
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x29:
+            INST_NAME("VMOVAPD Ex, Gx");
+            nextop = F8;
+            GETG;
+            v0 = sse_get_reg(dyn, ninst, x1, gd, 0);
+            if (MODREG) {
+                ed = (nextop & 7) + (rex.b << 3);
+                v1 = sse_get_reg_empty(dyn, ninst, x1, ed);
+                VOR_V(v1, v0, v0);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[gd]));
+                    VST(q0, xEmu, offsetof(x64emu_t, ymm[ed]));
+                } else {
+                    YMM0(ed);
+                }
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 16, 0);
+                VST(v0, ed, fixedaddress);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[gd]));
+                    VST(q0, ed, fixedaddress + 16);
+                }
+                SMWRITE2();
+            }
+            break;
+        case 0x54:
+            INST_NAME("VANDPD Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VAND_V(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x55:
+            INST_NAME("VANDNPD Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VANDN_V(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x56:
+            INST_NAME("VORPD Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VOR_V(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x57:
+            INST_NAME("VXORPD Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VXOR_V(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x64:
+            INST_NAME("VPCMPGTB Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VSLT_B(v0, v1, v2);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x65:
+            INST_NAME("VPCMPGTW Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VSLT_H(v0, v1, v2);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x66:
+            INST_NAME("VPCMPGTD Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VSLT_W(v0, v1, v2);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x6F:
+            INST_NAME("VMOVDQA Gx, Ex");
+            nextop = F8;
+            GETG;
+            if (MODREG) {
+                ed = (nextop & 7) + (rex.b << 3);
+                v1 = sse_get_reg(dyn, ninst, x1, ed, 0);
+                v0 = sse_get_reg_empty(dyn, ninst, x1, gd);
+                VOR_V(v0, v1, v1);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[ed]));
+                    PUTGY(q0);
+                }
+            } else {
+                v0 = sse_get_reg_empty(dyn, ninst, x1, gd);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 16, 0);
+                VLD(v0, ed, fixedaddress);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, ed, fixedaddress + 16);
+                    PUTGY(q0);
+                }
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x74:
+            INST_NAME("VPCMPEQB Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VSEQ_B(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x75:
+            INST_NAME("VPCMPEQW Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VSEQ_H(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x76:
+            INST_NAME("VPCMPEQD Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VSEQ_W(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x7F:
+            INST_NAME("VMOVDQA Ex, Gx");
+            nextop = F8;
+            GETG;
+            v0 = sse_get_reg(dyn, ninst, x1, gd, 0);
+            if (MODREG) {
+                ed = (nextop & 7) + (rex.b << 3);
+                v1 = sse_get_reg_empty(dyn, ninst, x1, ed);
+                VOR_V(v1, v0, v0);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[gd]));
+                    VST(q0, xEmu, offsetof(x64emu_t, ymm[ed]));
+                } else {
+                    YMM0(ed);
+                }
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 16, 0);
+                VST(v0, ed, fixedaddress);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[gd]));
+                    VST(q0, ed, fixedaddress + 16);
+                }
+                SMWRITE2();
+            }
+            break;
+        case 0xD4:
+            INST_NAME("VPADDQ Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VADD_D(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xDB:
+            INST_NAME("VPAND Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VAND_V(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xDF:
+            INST_NAME("VPANDN Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VANDN_V(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xEB:
+            INST_NAME("VPOR Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VOR_V(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xEF:
+            INST_NAME("VPXOR Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VXOR_V(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xF8:
+            INST_NAME("VPSUBB Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VSUB_B(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xF9:
+            INST_NAME("VPSUBW Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VSUB_H(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xFA:
+            INST_NAME("VPSUBD Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VSUB_W(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xFB:
+            INST_NAME("VPSUBQ Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VSUB_D(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xFC:
+            INST_NAME("VPADDB Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VADD_B(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xFD:
+            INST_NAME("VPADDW Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VADD_H(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xFE:
+            INST_NAME("VPADDD Gx, Vx, Ex");
+            nextop = F8;
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX(v0, v2, v1, 0); } else { GETGY_empty_VYEY(v0, v2, v1); }
+                VADD_W(v0, v2, v1);
+                if (l) PUTGY(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+
+        default:
+            DEFAULT;
+    }
+    return addr;
+}
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "la64_emitter.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+
+#include "la64_printer.h"
+#include "dynarec_la64_private.h"
+#include "dynarec_la64_functions.h"
+#include "dynarec_la64_helper.h"
+
+uintptr_t dynarec64_AVX_F3_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)need_epilog;
+
+    uint8_t opcode = F8;
+    uint8_t nextop;
+    uint8_t gd, ed;
+    int v0, v1, v2;
+    int q0;
+    int64_t fixedaddress;
+    rex_t rex = vex.rex;
+
+    MAYUSE(v2);
+    MAYUSE(q0);
+
+    switch (opcode) {
+        case 0x6F:
+            INST_NAME("VMOVDQU Gx, Ex");
+            nextop = F8;
+            GETG;
+            if (MODREG) {
+                ed = (nextop & 7) + (rex.b << 3);
+                v1 = sse_get_reg(dyn, ninst, x1, ed, 0);
+                v0 = sse_get_reg_empty(dyn, ninst, x1, gd);
+                VOR_V(v0, v1, v1);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[ed]));
+                    PUTGY(q0);
+                }
+            } else {
+                v0 = sse_get_reg_empty(dyn, ninst, x1, gd);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 16, 0);
+                VLD(v0, ed, fixedaddress);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, ed, fixedaddress + 16);
+                    PUTGY(q0);
+                }
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x7F:
+            INST_NAME("VMOVDQU Ex, Gx");
+            nextop = F8;
+            GETG;
+            v0 = sse_get_reg(dyn, ninst, x1, gd, 0);
+            if (MODREG) {
+                ed = (nextop & 7) + (rex.b << 3);
+                v1 = sse_get_reg_empty(dyn, ninst, x1, ed);
+                VOR_V(v1, v0, v0);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[gd]));
+                    VST(q0, xEmu, offsetof(x64emu_t, ymm[ed]));
+                } else {
+                    YMM0(ed);
+                }
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 16, 0);
+                VST(v0, ed, fixedaddress);
+                if (vex.l) {
+                    q0 = fpu_get_scratch(dyn);
+                    VLD(q0, xEmu, offsetof(x64emu_t, ymm[gd]));
+                    VST(q0, ed, fixedaddress + 16);
+                }
+                SMWRITE2();
+            }
+            break;
+
+        default:
+            DEFAULT;
+    }
+    return addr;
+}
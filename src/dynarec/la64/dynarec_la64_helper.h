@@ -40,13 +40,13 @@
 // All Write operation that might use a lock all have a memory barrier if strongmem is >= SMWRITE_MIN
 // Opcode will read
 #define SMREAD()                                                        \
-    if ((dyn->smread == 0) && (box64_dynarec_strongmem > SMREAD_MIN)) { \
+    if ((dyn->smread == 0) && (dyn->strongmem > SMREAD_MIN)) { \
         SMDMB();                                                        \
     } else                                                              \
         dyn->smread = 1
 // Opcode will read with option forced lock
 #define SMREADLOCK(lock) \
-    if ((lock) || ((dyn->smread == 0) && (box64_dynarec_strongmem > SMREAD_MIN))) { SMDMB(); }
+    if ((lock) || ((dyn->smread == 0) && (dyn->strongmem > SMREAD_MIN))) { SMDMB(); }
 // Opcode might read (depend on nextop)
 #define SMMIGHTREAD() \
     if (!MODREG) { SMREAD(); }
@@ -54,10 +54,10 @@
 #define SMWRITE() dyn->smwrite = 1
 // Opcode has wrote (strongmem>1 only)
 #define SMWRITE2() \
-    if (box64_dynarec_strongmem > SMREAD_MIN) dyn->smwrite = 1
+    if (dyn->strongmem > SMREAD_MIN) dyn->smwrite = 1
 // Opcode has wrote with option forced lock
 #define SMWRITELOCK(lock)                                  \
-    if (lock || (box64_dynarec_strongmem > SMWRITE_MIN)) { \
+    if (lock || (dyn->strongmem > SMWRITE_MIN)) { \
         SMDMB();                                           \
     } else                                                 \
         dyn->smwrite = 1
@@ -68,7 +68,7 @@
 #define SMSTART() SMEND()
 // End of sequence
 #define SMEND()                                               \
-    if (dyn->smwrite && box64_dynarec_strongmem) { DBAR(0); } \
+    if (dyn->smwrite && dyn->strongmem) { DBAR(0); } \
     dyn->smwrite = 0;                                         \
     dyn->smread = 0;
 // Force a Data memory barrier (for LOCK: prefix)
@@ -365,6 +365,47 @@
         SMWRITE2();               \
     }
 
+// Get VX as a quad (might use x1)
+#define GETVX(a, w) \
+    a = sse_get_reg(dyn, ninst, x1, vex.v, w)
+
+// Get EX as a quad for an AVX opcode, ed/fixedaddress stay valid for the upper 128bits (x1 is used)
+#define GETEX_Y(a, w, D)                                                                      \
+    if (MODREG) {                                                                             \
+        a = sse_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), w);                      \
+    } else {                                                                                  \
+        SMREAD();                                                                             \
+        addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 16, D); \
+        a = fpu_get_scratch(dyn);                                                             \
+        VLD(a, ed, fixedaddress);                                                             \
+    }
+
+// Get empty GX, and non-written VX and EX
+#define GETGX_empty_VXEX(gx, vx, ex, D) \
+    GETVX(vx, 0);                       \
+    GETEX_Y(ex, 0, D);                  \
+    GETGX_empty(gx)
+
+// The upper 128bits of the ymm regs are not cached, they live in x64emu_t
+// Get empty GY, and non-written VY and EY, as scratch regs (GY needs a PUTGY)
+#define GETGY_empty_VYEY(gy, vy, ey)                                              \
+    vy = fpu_get_scratch(dyn);                                                    \
+    VLD(vy, xEmu, offsetof(x64emu_t, ymm[vex.v]));                                \
+    ey = fpu_get_scratch(dyn);                                                    \
+    if (MODREG)                                                                   \
+        VLD(ey, xEmu, offsetof(x64emu_t, ymm[(nextop & 7) + (rex.b << 3)]));      \
+    else                                                                          \
+        VLD(ey, ed, fixedaddress + 16);                                           \
+    gy = fpu_get_scratch(dyn)
+
+// Write back GY
+#define PUTGY(gy) VST(gy, xEmu, offsetof(x64emu_t, ymm[gd]))
+
+// Zero the upper 128bits of ymm reg a
+#define YMM0(a)                                  \
+    ST_D(xZR, xEmu, offsetof(x64emu_t, ymm[a])); \
+    ST_D(xZR, xEmu, offsetof(x64emu_t, ymm[a]) + 8)
+
 // Get Ex as a double, not a quad (warning, x1 get used, x2 might too)
 #define GETEXSD(a, w, D)                                                                     \
     if (MODREG) {                                                                            \
@@ -744,29 +785,29 @@
 #define GETIP_(A) TABLE64(0, 0)
 #else
 // put value in the Table64 even if not using it for now to avoid difference between Step2 and Step3. Needs to be optimized later...
-#define GETIP(A)                                     \
-    if (dyn->last_ip && ((A)-dyn->last_ip) < 2048) { \
-        uint64_t _delta_ip = (A)-dyn->last_ip;       \
-        dyn->last_ip += _delta_ip;                   \
-        if (_delta_ip) {                             \
-            ADDI_D(xRIP, xRIP, _delta_ip);           \
-        }                                            \
-    } else {                                         \
-        dyn->last_ip = (A);                          \
-        if (dyn->last_ip < 0xffffffff) {             \
-            MOV64x(xRIP, dyn->last_ip);              \
-        } else                                       \
-            TABLE64(xRIP, dyn->last_ip);             \
+#define GETIP(A)                                            \
+    if (dyn->last_ip && ((A)-dyn->last_ip + 2048) < 4096) { \
+        int64_t _delta_ip = (A)-dyn->last_ip;               \
+        dyn->last_ip += _delta_ip;                          \
+        if (_delta_ip) {                                    \
+            ADDI_D(xRIP, xRIP, _delta_ip);                  \
+        }                                                   \
+    } else {                                                \
+        dyn->last_ip = (A);                                 \
+        if (dyn->last_ip < 0xffffffff) {                    \
+            MOV64x(xRIP, dyn->last_ip);                     \
+        } else                                              \
+            TABLE64(xRIP, dyn->last_ip);                    \
     }
-#define GETIP_(A)                                         \
-    if (dyn->last_ip && ((A)-dyn->last_ip) < 2048) {      \
-        int64_t _delta_ip = (A)-dyn->last_ip;             \
-        if (_delta_ip) { ADDI_D(xRIP, xRIP, _delta_ip); } \
-    } else {                                              \
-        if ((A) < 0xffffffff) {                           \
-            MOV64x(xRIP, (A));                            \
-        } else                                            \
-            TABLE64(xRIP, (A));                           \
+#define GETIP_(A)                                           \
+    if (dyn->last_ip && ((A)-dyn->last_ip + 2048) < 4096) { \
+        int64_t _delta_ip = (A)-dyn->last_ip;               \
+        if (_delta_ip) { ADDI_D(xRIP, xRIP, _delta_ip); }   \
+    } else {                                                \
+        if ((A) < 0xffffffff) {                             \
+            MOV64x(xRIP, (A));                              \
+        } else                                              \
+            TABLE64(xRIP, (A));                             \
     }
 #endif
 #define CLEARIP() dyn->last_ip = 0
@@ -805,6 +846,10 @@ void* la64_next(x64emu_t* emu, uintptr_t addr);
 #define dynarec64_660F STEPNAME(dynarec64_660F)
 #define dynarec64_F0   STEPNAME(dynarec64_F0)
 #define dynarec64_F20F STEPNAME(dynarec64_F20F)
+#define dynarec64_AVX       STEPNAME(dynarec64_AVX)
+#define dynarec64_AVX_0F    STEPNAME(dynarec64_AVX_0F)
+#define dynarec64_AVX_66_0F STEPNAME(dynarec64_AVX_66_0F)
+#define dynarec64_AVX_F3_0F STEPNAME(dynarec64_AVX_F3_0F)
 
 #define geted               STEPNAME(geted)
 #define geted32             STEPNAME(geted32)
@@ -1035,6 +1080,10 @@ uintptr_t dynarec64_67(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
 uintptr_t dynarec64_660F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
 uintptr_t dynarec64_F0(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
 uintptr_t dynarec64_F20F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_66_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_F3_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
 
 #if STEP < 3
 #define PASS3(A)
@@ -126,9 +126,11 @@ typedef struct dynarec_la64_s {
     uintptr_t            forward_to; // address of the next jump to (to check if everything is ok)
     int32_t              forward_size;   // size at the forward point
     int                  forward_ninst;  // ninst at the forward point
+    uintptr_t            peek_end;   // end of the code checked after the block (for flags liveness)
     uint16_t             ymm_zero;   // bitmap of ymm to zero at purge
     uint8_t              smread;    // for strongmem model emulation
     uint8_t              smwrite;    // for strongmem model emulation
+    uint8_t              strongmem;  // strongmem level used for this block
     uint8_t              always_test;
     uint8_t              abort;
 } dynarec_la64_t;
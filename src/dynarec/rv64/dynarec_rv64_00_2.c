@@ -397,6 +397,10 @@ uintptr_t dynarec64_00_2(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
             GETGD;
             if(MODREG) {
                 MVxw(gd, xRAX+(nextop&7)+(rex.b<<3));
+            } else if(dyn->insts[ninst].x64.fwd_reg) {
+                // value stored there earlier in the block, still in a register: no need to compute the address
+                FAKEED;
+                MVxw(gd, xRAX+dyn->insts[ninst].x64.fwd_reg-1);
             } else {
                 addr = geted(dyn, addr, ninst, nextop, &ed, x2, x1, &fixedaddress, rex, &lock, 1, 0);
                 SMREADLOCK(lock);
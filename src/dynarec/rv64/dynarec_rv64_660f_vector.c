@@ -139,10 +139,154 @@ uintptr_t dynarec64_660F_vector(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t i
                     vector_vsetvli(dyn, ninst, x1, VECTOR_SEW16, VECTOR_LMUL1, 1);
                     VNSRL_WI(q0, 1, v0, VECTOR_UNMASKED);
                     break;
+                case 0x1C ... 0x1E:
+                    if (nextop == 0x1C) {
+                        INST_NAME("PABSB Gx, Ex");
+                        u8 = VECTOR_SEW8;
+                    } else if (nextop == 0x1D) {
+                        INST_NAME("PABSW Gx, Ex");
+                        u8 = VECTOR_SEW16;
+                    } else {
+                        INST_NAME("PABSD Gx, Ex");
+                        u8 = VECTOR_SEW32;
+                    }
+                    nextop = F8;
+                    SET_ELEMENT_WIDTH(x1, u8, 1);
+                    GETEX_vector(q1, 0, 0, u8);
+                    GETGX_empty_vector(q0);
+                    v0 = fpu_get_scratch(dyn);
+                    VRSUB_VI(v0, 0, q1, VECTOR_UNMASKED);
+                    VMAX_VV(q0, v0, q1, VECTOR_UNMASKED);
+                    break;
+                case 0x29:
+                    INST_NAME("PCMPEQQ Gx, Ex");
+                    nextop = F8;
+                    SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+                    GETGX_vector(q0, 1, VECTOR_SEW64);
+                    GETEX_vector(q1, 0, 0, VECTOR_SEW64);
+                    VMSEQ_VV(VMASK, q1, q0, VECTOR_UNMASKED);
+                    VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+                    VMERGE_VIM(q0, 0x1f, q0); // implies VMASK
+                    break;
+                case 0x37:
+                    INST_NAME("PCMPGTQ Gx, Ex");
+                    nextop = F8;
+                    SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+                    GETGX_vector(q0, 1, VECTOR_SEW64);
+                    GETEX_vector(q1, 0, 0, VECTOR_SEW64);
+                    VMSLT_VV(VMASK, q0, q1, VECTOR_UNMASKED);
+                    VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+                    VMERGE_VIM(q0, 0x1f, q0); // implies VMASK
+                    break;
+                case 0x38 ... 0x3F:
+                    switch (nextop) {
+                        case 0x38: INST_NAME("PMINSB Gx, Ex"); u8 = VECTOR_SEW8; break;
+                        case 0x39: INST_NAME("PMINSD Gx, Ex"); u8 = VECTOR_SEW32; break;
+                        case 0x3A: INST_NAME("PMINUW Gx, Ex"); u8 = VECTOR_SEW16; break;
+                        case 0x3B: INST_NAME("PMINUD Gx, Ex"); u8 = VECTOR_SEW32; break;
+                        case 0x3C: INST_NAME("PMAXSB Gx, Ex"); u8 = VECTOR_SEW8; break;
+                        case 0x3D: INST_NAME("PMAXSD Gx, Ex"); u8 = VECTOR_SEW32; break;
+                        case 0x3E: INST_NAME("PMAXUW Gx, Ex"); u8 = VECTOR_SEW16; break;
+                        default: INST_NAME("PMAXUD Gx, Ex"); u8 = VECTOR_SEW32; break;
+                    }
+                    opcode = nextop;
+                    nextop = F8;
+                    SET_ELEMENT_WIDTH(x1, u8, 1);
+                    GETGX_vector(q0, 1, u8);
+                    GETEX_vector(q1, 0, 0, u8);
+                    switch (opcode) {
+                        case 0x38:
+                        case 0x39: VMIN_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                        case 0x3A:
+                        case 0x3B: VMINU_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                        case 0x3C:
+                        case 0x3D: VMAX_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                        default: VMAXU_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                    }
+                    break;
+                case 0x40:
+                    INST_NAME("PMULLD Gx, Ex");
+                    nextop = F8;
+                    SET_ELEMENT_WIDTH(x1, VECTOR_SEW32, 1);
+                    GETGX_vector(q0, 1, VECTOR_SEW32);
+                    GETEX_vector(q1, 0, 0, VECTOR_SEW32);
+                    VMUL_VV(q0, q1, q0, VECTOR_UNMASKED);
+                    break;
                 default:
                     DEFAULT_VECTOR;
             }
             break;
+        case 0x51:
+            if (!box64_dynarec_fastnan) return 0; // the scalar version fixes the sign of generated NaNs
+            INST_NAME("SQRTPD Gx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            GETEX_vector(q1, 0, 0, VECTOR_SEW64);
+            GETGX_empty_vector(q0);
+            VFSQRT_V(q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0x54:
+            INST_NAME("ANDPD Gx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEWANY, 1);
+            GETGX_vector(q0, 1, dyn->vector_eew);
+            GETEX_vector(q1, 0, 0, dyn->vector_eew);
+            VAND_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0x55:
+            INST_NAME("ANDNPD Gx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEWANY, 1);
+            GETGX_vector(q0, 1, dyn->vector_eew);
+            GETEX_vector(q1, 0, 0, dyn->vector_eew);
+            VXOR_VI(q0, 0x1f, q0, VECTOR_UNMASKED);
+            VAND_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0x56:
+            INST_NAME("ORPD Gx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEWANY, 1);
+            GETGX_vector(q0, 1, dyn->vector_eew);
+            GETEX_vector(q1, 0, 0, dyn->vector_eew);
+            VOR_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0x57:
+            INST_NAME("XORPD Gx, Ex");
+            nextop = F8;
+            GETG;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEWANY, 1);
+            if (MODREG && gd == (nextop & 7) + (rex.b << 3)) {
+                // special case
+                q0 = sse_get_reg_empty_vector(dyn, ninst, x1, gd);
+                VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            } else {
+                q0 = sse_get_reg_vector(dyn, ninst, x1, gd, 1, dyn->vector_eew);
+                GETEX_vector(q1, 0, 0, dyn->vector_eew);
+                VXOR_VV(q0, q1, q0, VECTOR_UNMASKED);
+            }
+            break;
+        case 0x58:
+        case 0x59:
+        case 0x5C:
+        case 0x5E:
+            if (!box64_dynarec_fastnan) return 0; // the scalar version fixes the sign of generated NaNs
+            switch (opcode) {
+                case 0x58: INST_NAME("ADDPD Gx, Ex"); break;
+                case 0x59: INST_NAME("MULPD Gx, Ex"); break;
+                case 0x5C: INST_NAME("SUBPD Gx, Ex"); break;
+                default: INST_NAME("DIVPD Gx, Ex"); break;
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            GETGX_vector(q0, 1, VECTOR_SEW64);
+            GETEX_vector(q1, 0, 0, VECTOR_SEW64);
+            switch (opcode) {
+                case 0x58: VFADD_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                case 0x59: VFMUL_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                case 0x5C: VFSUB_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                default: VFDIV_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+            }
+            break;
         case 0x61:
             INST_NAME("PUNPCKLWD Gx, Ex");
             nextop = F8;
@@ -249,6 +393,90 @@ uintptr_t dynarec64_660F_vector(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t i
                 VLE_V(v0, ed, dyn->vector_eew, VECTOR_UNMASKED, VECTOR_NFIELD1);
             }
             break;
+        case 0x71:
+        case 0x72:
+        case 0x73:
+            nextop = F8;
+            u8 = (nextop >> 3) & 7;
+            if (!MODREG || (u8 != 2 && u8 != 4 && u8 != 6) || (opcode == 0x73 && u8 == 4)) {
+                // PSRLDQ/PSLLDQ (and invalid encodings) stay on the scalar path
+                DEFAULT_VECTOR;
+            }
+            s8 = (opcode == 0x71) ? VECTOR_SEW16 : ((opcode == 0x72) ? VECTOR_SEW32 : VECTOR_SEW64);
+            i32 = (opcode == 0x71) ? 16 : ((opcode == 0x72) ? 32 : 64);
+            switch (u8) {
+                case 2:
+                    if (opcode == 0x71) { INST_NAME("PSRLW Ex, Ib"); } else if (opcode == 0x72) { INST_NAME("PSRLD Ex, Ib"); } else { INST_NAME("PSRLQ Ex, Ib"); }
+                    break;
+                case 4:
+                    if (opcode == 0x71) { INST_NAME("PSRAW Ex, Ib"); } else { INST_NAME("PSRAD Ex, Ib"); }
+                    break;
+                default:
+                    if (opcode == 0x71) { INST_NAME("PSLLW Ex, Ib"); } else if (opcode == 0x72) { INST_NAME("PSLLD Ex, Ib"); } else { INST_NAME("PSLLQ Ex, Ib"); }
+                    break;
+            }
+            SET_ELEMENT_WIDTH(x1, s8, 1);
+            GETEX_vector(q0, 1, 1, s8);
+            u8 = F8;
+            if (((nextop >> 3) & 7) == 4) {
+                // arithmetic shift saturates to the sign
+                if (u8 > i32 - 1) u8 = i32 - 1;
+                if (u8) VSRA_VI(q0, u8, q0, VECTOR_UNMASKED);
+            } else if (u8 >= i32) {
+                VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            } else if (u8) {
+                if (u8 > 31) {
+                    MOV32w(x4, u8);
+                    if (((nextop >> 3) & 7) == 2) {
+                        VSRL_VX(q0, x4, q0, VECTOR_UNMASKED);
+                    } else {
+                        VSLL_VX(q0, x4, q0, VECTOR_UNMASKED);
+                    }
+                } else if (((nextop >> 3) & 7) == 2) {
+                    VSRL_VI(q0, u8, q0, VECTOR_UNMASKED);
+                } else {
+                    VSLL_VI(q0, u8, q0, VECTOR_UNMASKED);
+                }
+            }
+            break;
+        case 0x64 ... 0x66:
+            if (opcode == 0x64) {
+                INST_NAME("PCMPGTB Gx, Ex");
+                u8 = VECTOR_SEW8;
+            } else if (opcode == 0x65) {
+                INST_NAME("PCMPGTW Gx, Ex");
+                u8 = VECTOR_SEW16;
+            } else {
+                INST_NAME("PCMPGTD Gx, Ex");
+                u8 = VECTOR_SEW32;
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, u8, 1);
+            GETGX_vector(q0, 1, u8);
+            GETEX_vector(q1, 0, 0, u8);
+            VMSLT_VV(VMASK, q0, q1, VECTOR_UNMASKED);
+            VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            VMERGE_VIM(q0, 0x1f, q0); // implies VMASK
+            break;
+        case 0x74 ... 0x76:
+            if (opcode == 0x74) {
+                INST_NAME("PCMPEQB Gx, Ex");
+                u8 = VECTOR_SEW8;
+            } else if (opcode == 0x75) {
+                INST_NAME("PCMPEQW Gx, Ex");
+                u8 = VECTOR_SEW16;
+            } else {
+                INST_NAME("PCMPEQD Gx, Ex");
+                u8 = VECTOR_SEW32;
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, u8, 1);
+            GETGX_vector(q0, 1, u8);
+            GETEX_vector(q1, 0, 0, u8);
+            VMSEQ_VV(VMASK, q1, q0, VECTOR_UNMASKED);
+            VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            VMERGE_VIM(q0, 0x1f, q0); // implies VMASK
+            break;
         case 0x7E:
             return 0;
         case 0xEF:
@@ -283,6 +511,122 @@ uintptr_t dynarec64_660F_vector(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t i
             GETEX_vector(q1, 0, 0, dyn->vector_eew);
             VAND_VV(q0, q0, q1, VECTOR_UNMASKED);
             break;
+        case 0xD5:
+        case 0xE4:
+        case 0xE5:
+            if (opcode == 0xD5) {
+                INST_NAME("PMULLW Gx, Ex");
+            } else if (opcode == 0xE4) {
+                INST_NAME("PMULHUW Gx, Ex");
+            } else {
+                INST_NAME("PMULHW Gx, Ex");
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW16, 1);
+            GETGX_vector(q0, 1, VECTOR_SEW16);
+            GETEX_vector(q1, 0, 0, VECTOR_SEW16);
+            if (opcode == 0xD5) {
+                VMUL_VV(q0, q1, q0, VECTOR_UNMASKED);
+            } else if (opcode == 0xE4) {
+                VMULHU_VV(q0, q1, q0, VECTOR_UNMASKED);
+            } else {
+                VMULH_VV(q0, q1, q0, VECTOR_UNMASKED);
+            }
+            break;
+        case 0xD8:
+        case 0xD9:
+        case 0xDC:
+        case 0xDD:
+        case 0xE8:
+        case 0xE9:
+        case 0xEC:
+        case 0xED:
+            switch (opcode) {
+                case 0xD8: INST_NAME("PSUBUSB Gx, Ex"); break;
+                case 0xD9: INST_NAME("PSUBUSW Gx, Ex"); break;
+                case 0xDC: INST_NAME("PADDUSB Gx, Ex"); break;
+                case 0xDD: INST_NAME("PADDUSW Gx, Ex"); break;
+                case 0xE8: INST_NAME("PSUBSB Gx, Ex"); break;
+                case 0xE9: INST_NAME("PSUBSW Gx, Ex"); break;
+                case 0xEC: INST_NAME("PADDSB Gx, Ex"); break;
+                default: INST_NAME("PADDSW Gx, Ex"); break;
+            }
+            u8 = (opcode & 1) ? VECTOR_SEW16 : VECTOR_SEW8;
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, u8, 1);
+            GETGX_vector(q0, 1, u8);
+            GETEX_vector(q1, 0, 0, u8);
+            switch (opcode & 0xFE) {
+                case 0xD8: VSSUBU_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                case 0xDC: VSADDU_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                case 0xE8: VSSUB_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                default: VSADD_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+            }
+            break;
+        case 0xDA:
+        case 0xDE:
+        case 0xEA:
+        case 0xEE:
+            switch (opcode) {
+                case 0xDA: INST_NAME("PMINUB Gx, Ex"); break;
+                case 0xDE: INST_NAME("PMAXUB Gx, Ex"); break;
+                case 0xEA: INST_NAME("PMINSW Gx, Ex"); break;
+                default: INST_NAME("PMAXSW Gx, Ex"); break;
+            }
+            u8 = (opcode < 0xE0) ? VECTOR_SEW8 : VECTOR_SEW16;
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, u8, 1);
+            GETGX_vector(q0, 1, u8);
+            GETEX_vector(q1, 0, 0, u8);
+            switch (opcode) {
+                case 0xDA: VMINU_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                case 0xDE: VMAXU_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                case 0xEA: VMIN_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+                default: VMAX_VV(q0, q1, q0, VECTOR_UNMASKED); break;
+            }
+            break;
+        case 0xDF:
+            INST_NAME("PANDN Gx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEWANY, 1);
+            GETGX_vector(q0, 1, dyn->vector_eew);
+            GETEX_vector(q1, 0, 0, dyn->vector_eew);
+            VXOR_VI(q0, 0x1f, q0, VECTOR_UNMASKED);
+            VAND_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xEB:
+            INST_NAME("POR Gx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEWANY, 1);
+            GETGX_vector(q0, 1, dyn->vector_eew);
+            GETEX_vector(q1, 0, 0, dyn->vector_eew);
+            VOR_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xF8 ... 0xFB:
+            switch (opcode) {
+                case 0xF8: INST_NAME("PSUBB Gx, Ex"); u8 = VECTOR_SEW8; break;
+                case 0xF9: INST_NAME("PSUBW Gx, Ex"); u8 = VECTOR_SEW16; break;
+                case 0xFA: INST_NAME("PSUBD Gx, Ex"); u8 = VECTOR_SEW32; break;
+                default: INST_NAME("PSUBQ Gx, Ex"); u8 = VECTOR_SEW64; break;
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, u8, 1);
+            GETGX_vector(q0, 1, u8);
+            GETEX_vector(q1, 0, 0, u8);
+            VSUB_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xFC ... 0xFE:
+            switch (opcode) {
+                case 0xFC: INST_NAME("PADDB Gx, Ex"); u8 = VECTOR_SEW8; break;
+                case 0xFD: INST_NAME("PADDW Gx, Ex"); u8 = VECTOR_SEW16; break;
+                default: INST_NAME("PADDD Gx, Ex"); u8 = VECTOR_SEW32; break;
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, u8, 1);
+            GETGX_vector(q0, 1, u8);
+            GETEX_vector(q1, 0, 0, u8);
+            VADD_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
         default:
             DEFAULT_VECTOR;
     }
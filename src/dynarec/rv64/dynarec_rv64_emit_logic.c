@@ -87,6 +87,17 @@ void emit_xor32(dynarec_rv64_t* dyn, int ninst, rex_t rex, int s1, int s2, int s
         SET_DFNONE();
     }
 
+    if (s1 == s2) {
+        // xor r, r: result is 0, so all flags are known
+        MV(s1, xZR);
+        IFX(X_PEND) {
+            SDxw(xZR, xEmu, offsetof(x64emu_t, res));
+        }
+        IFX(X_ZF | X_PF) {
+            ORI(xFlags, xFlags, (1 << F_ZF) | (1 << F_PF));
+        }
+        return;
+    }
     XOR(s1, s1, s2);
 
     // test sign bit before zeroup.
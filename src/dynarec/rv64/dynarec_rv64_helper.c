@@ -1106,9 +1106,14 @@ void x87_purgecache(dynarec_rv64_t* dyn, int ninst, int next, int s1, int s2, in
                     MESSAGE(LOG_DUMP, "Warning, incoherency with purged ST%d cache\n", st);
                 }
                 #endif
-                ADDI(s3, s2, dyn->e.x87cache[i]); // unadjusted count, as it's relative to real top
-                ANDI(s3, s3, 7);   // (emu->top + st)&7
-                if(rv64_zba) SH3ADD(s1, s3, xEmu); else {SLLI(s1, s3, 3); ADD(s1, xEmu, s1);}
+                // ST0 is at top itself (already in 0..7), no need to compute the index
+                int idx = s2;
+                if(dyn->e.x87cache[i]) {
+                    idx = s3;
+                    ADDI(s3, s2, dyn->e.x87cache[i]); // unadjusted count, as it's relative to real top
+                    ANDI(s3, s3, 7);   // (emu->top + st)&7
+                }
+                if(rv64_zba) SH3ADD(s1, idx, xEmu); else {SLLI(s1, idx, 3); ADD(s1, xEmu, s1);}
                 switch(extcache_get_current_st(dyn, ninst, st)) {
                     case EXT_CACHE_ST_D:
                         FSD(dyn->e.x87reg[i], s1, offsetof(x64emu_t, x87));    // save the value
@@ -1184,9 +1189,13 @@ static void x87_reflectcache(dynarec_rv64_t* dyn, int ninst, int s1, int s2, int
     // loop all cache entries
     for (int i=0; i<8; ++i)
         if(dyn->e.x87cache[i]!=-1) {
-            ADDI(s3, s2, dyn->e.x87cache[i]);
-            ANDI(s3, s3, 7);   // (emu->top + i)&7
-            if(rv64_zba) SH3ADD(s1, s3, xEmu); else {SLLI(s1, s3, 3); ADD(s1, xEmu, s1);}
+            int idx = s2;
+            if(dyn->e.x87cache[i]) {
+                idx = s3;
+                ADDI(s3, s2, dyn->e.x87cache[i]);
+                ANDI(s3, s3, 7);   // (emu->top + i)&7
+            }
+            if(rv64_zba) SH3ADD(s1, idx, xEmu); else {SLLI(s1, idx, 3); ADD(s1, xEmu, s1);}
             if(extcache_get_st_f(dyn, ninst, dyn->e.x87cache[i])>=0) {
                 FCVTDS(SCRATCH0, dyn->e.x87reg[i]);
                 FSD(SCRATCH0, s1, offsetof(x64emu_t, x87));
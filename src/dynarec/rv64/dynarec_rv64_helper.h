@@ -42,23 +42,23 @@
 // Sequence of Write will trigger a DMB on "last" write if strongmem is >= 1
 // All Write operation that might use a lock all have a memory barrier if strongmem is >= SMWRITE_MIN
 // Opcode will read
-#define SMREAD() if((dyn->smread==0) && (box64_dynarec_strongmem>SMREAD_MIN)) {SMDMB();} else dyn->smread=1
+#define SMREAD() if((dyn->smread==0) && (dyn->strongmem>SMREAD_MIN)) {SMDMB();} else dyn->smread=1
 // Opcode will read with option forced lock
-#define SMREADLOCK(lock)    if((lock) || ((dyn->smread==0) && (box64_dynarec_strongmem>SMREAD_MIN))) {SMDMB();}
+#define SMREADLOCK(lock)    if((lock) || ((dyn->smread==0) && (dyn->strongmem>SMREAD_MIN))) {SMDMB();}
 // Opcode might read (depend on nextop)
 #define SMMIGHTREAD()   if(!MODREG) {SMREAD();}
 // Opcode has wrote
 #define SMWRITE()   dyn->smwrite=1
 // Opcode has wrote (strongmem>1 only)
-#define SMWRITE2()   if(box64_dynarec_strongmem>SMREAD_MIN) dyn->smwrite=1
+#define SMWRITE2()   if(dyn->strongmem>SMREAD_MIN) dyn->smwrite=1
 // Opcode has wrote with option forced lock
-#define SMWRITELOCK(lock)   if(lock || (box64_dynarec_strongmem>SMWRITE_MIN)) {SMDMB();} else dyn->smwrite=1
+#define SMWRITELOCK(lock)   if(lock || (dyn->strongmem>SMWRITE_MIN)) {SMDMB();} else dyn->smwrite=1
 // Opcode might have wrote (depend on nextop)
 #define SMMIGHTWRITE()   if(!MODREG) {SMWRITE();}
 // Start of sequence
 #define SMSTART()   SMEND()
 // End of sequence
-#define SMEND()     if(dyn->smwrite && box64_dynarec_strongmem) {FENCE();} dyn->smwrite=0; dyn->smread=0;
+#define SMEND()     if(dyn->smwrite && dyn->strongmem) {FENCE();} dyn->smwrite=0; dyn->smread=0;
 // Force a Data memory barrier (for LOCK: prefix)
 #define SMDMB()     FENCE(); dyn->smwrite=0; dyn->smread=1
 
@@ -1043,33 +1043,33 @@
 #define GETIP_(A) TABLE64(0, 0)
 #else
 // put value in the Table64 even if not using it for now to avoid difference between Step2 and Step3. Needs to be optimized later...
-#define GETIP(A)                                     \
-    if (dyn->last_ip && ((A)-dyn->last_ip) < 2048) { \
-        uint64_t _delta_ip = (A)-dyn->last_ip;       \
-        dyn->last_ip += _delta_ip;                   \
-        if (_delta_ip) {                             \
-            if (STEP == 4) dyn->skip_preload = 1;    \
-            ADDI(xRIP, xRIP, _delta_ip);             \
-        }                                            \
-    } else {                                         \
-        dyn->last_ip = (A);                          \
-        if (dyn->last_ip < 0xffffffff) {             \
-            MOV64x(xRIP, dyn->last_ip);              \
-        } else                                       \
-            TABLE64(xRIP, dyn->last_ip);             \
+#define GETIP(A)                                            \
+    if (dyn->last_ip && ((A)-dyn->last_ip + 2048) < 4096) { \
+        int64_t _delta_ip = (A)-dyn->last_ip;               \
+        dyn->last_ip += _delta_ip;                          \
+        if (_delta_ip) {                                    \
+            if (STEP == 4) dyn->skip_preload = 1;           \
+            ADDI(xRIP, xRIP, _delta_ip);                    \
+        }                                                   \
+    } else {                                                \
+        dyn->last_ip = (A);                                 \
+        if (dyn->last_ip < 0xffffffff) {                    \
+            MOV64x(xRIP, dyn->last_ip);                     \
+        } else                                              \
+            TABLE64(xRIP, dyn->last_ip);                    \
     }
-#define GETIP_(A)                                       \
-    if (dyn->last_ip && ((A)-dyn->last_ip) < 2048) {    \
-        int64_t _delta_ip = (A)-dyn->last_ip;           \
-        if (_delta_ip) {                                \
-            if (STEP == 4) dyn->skip_preload = 1;       \
-            ADDI(xRIP, xRIP, _delta_ip);                \
-        }                                               \
-    } else {                                            \
-        if ((A) < 0xffffffff) {                         \
-            MOV64x(xRIP, (A));                          \
-        } else                                          \
-            TABLE64(xRIP, (A));                         \
+#define GETIP_(A)                                           \
+    if (dyn->last_ip && ((A)-dyn->last_ip + 2048) < 4096) { \
+        int64_t _delta_ip = (A)-dyn->last_ip;               \
+        if (_delta_ip) {                                    \
+            if (STEP == 4) dyn->skip_preload = 1;           \
+            ADDI(xRIP, xRIP, _delta_ip);                    \
+        }                                                   \
+    } else {                                                \
+        if ((A) < 0xffffffff) {                             \
+            MOV64x(xRIP, (A));                              \
+        } else                                              \
+            TABLE64(xRIP, (A));                             \
     }
 #endif
 #define CLEARIP() dyn->last_ip = 0
@@ -235,8 +235,6 @@ static int SymbolMatch(elfheader_t* h, uint32_t i, int ver, const char* vername,
 {
     int version = h->VerSym?((Elf64_Half*)((uintptr_t)h->VerSym+h->delta))[i]:-1;
     if(version!=-1) version &=0x7fff;
-    const char* symvername = GetSymbolVersion(h, version);
-    Elf64_Half flags = GetSymbolVersionFlag(h, version);
     if(ver==-1 || version==-1)
         return 1;
     if(version==0 && !local)
@@ -247,9 +245,13 @@ static int SymbolMatch(elfheader_t* h, uint32_t i, int ver, const char* vername,
         return 1;
     if(ver==1 && version<2)
         return 1;
-    if(ver<2 && version>1 && flags==0)  // flag is not WEAK, so global works
+    // version tables are only walked when really needed
+    if(ver<2 && version>1 && GetSymbolVersionFlag(h, version)==0)  // flag is not WEAK, so global works
         return 1;
-    if(ver<2 || !symvername)
+    if(ver<2)
+        return 0;
+    const char* symvername = GetSymbolVersion(h, version);
+    if(!symvername)
         return 0;
     return strcmp(vername, symvername)?0:1;
 }
@@ -276,7 +278,7 @@ static Elf64_Sym* old_elf_lookup(elfheader_t* h, const char* symname, int ver, c
     const uint32_t *buckets = &hashtab[2];
     const uint32_t *chains = &buckets[nbuckets];
     // get hash from symname to lookup
-    const uint32_t hash = old_elf_hash(symname);
+    const uint32_t hash = GetOldElfHash(symname);
     // Search for it
     for (uint32_t i = buckets[hash % nbuckets]; i; i = chains[i]) {
         const char* name = h->DynStr + h->DynSym._64[i].st_name;
@@ -316,6 +318,46 @@ uint32_t new_elf_hash(const char *name)
     return h;
 }
 
+// hashes of the symbol currently searched by the librarian, so they are not recomputed for every elf
+static __thread elfsymhash_t* cur_symhash = NULL;
+
+void PushSymbolHash(elfsymhash_t* h, const char* name)
+{
+    h->name = name;
+    h->flags = 0;
+    h->prev = cur_symhash;
+    cur_symhash = h;
+}
+
+void PopSymbolHash(elfsymhash_t* h)
+{
+    cur_symhash = h->prev;
+}
+
+uint32_t GetOldElfHash(const char* name)
+{
+    elfsymhash_t* h = cur_symhash;
+    if(!h || h->name!=name)
+        return old_elf_hash(name);
+    if(!(h->flags&SYMHASH_SYSV)) {
+        h->sysv = old_elf_hash(name);
+        h->flags |= SYMHASH_SYSV;
+    }
+    return h->sysv;
+}
+
+uint32_t GetNewElfHash(const char* name)
+{
+    elfsymhash_t* h = cur_symhash;
+    if(!h || h->name!=name)
+        return new_elf_hash(name);
+    if(!(h->flags&SYMHASH_GNU)) {
+        h->gnu = new_elf_hash(name);
+        h->flags |= SYMHASH_GNU;
+    }
+    return h->gnu;
+}
+
 static Elf64_Sym* new_elf_lookup(elfheader_t* h, const char* symname, int ver, const char* vername, int local, int veropt)
 {
     // Prepare hash table
@@ -328,7 +370,7 @@ static Elf64_Sym* new_elf_lookup(elfheader_t* h, const char* symname, int ver, c
     const uint32_t *buckets = (uint32_t*)&blooms[bloom_size];
     const uint32_t *chains = &buckets[nbuckets];
     // get hash from symname to lookup
-    const uint32_t hash = new_elf_hash(symname);
+    const uint32_t hash = GetNewElfHash(symname);
     // early check with bloom: if at least one bit is not set, a symbol is surely missing.
     uint64_t word = blooms[(hash/64)%bloom_size];
     uint64_t mask = 0
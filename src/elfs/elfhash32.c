@@ -22,8 +22,6 @@ static int SymbolMatch(elfheader_t* h, uint32_t i, int ver, const char* vername,
 {
     int version = h->VerSym?((Elf32_Half*)((uintptr_t)h->VerSym+h->delta))[i]:-1;
     if(version!=-1) version &=0x7fff;
-    const char* symvername = GetSymbolVersion(h, version);
-    Elf32_Half flags = GetSymbolVersionFlag(h, version);
     if(ver==-1 || version==-1)
         return 1;
     if(version==0 && !local)
@@ -34,9 +32,13 @@ static int SymbolMatch(elfheader_t* h, uint32_t i, int ver, const char* vername,
         return 1;
     if(ver==1 && version<2)
         return 1;
-    if(ver<2 && version>1 && flags==0)  // flag is not WEAK, so global works
+    // version tables are only walked when really needed
+    if(ver<2 && version>1 && GetSymbolVersionFlag(h, version)==0)  // flag is not WEAK, so global works
         return 1;
-    if(ver<2 || !symvername)
+    if(ver<2)
+        return 0;
+    const char* symvername = GetSymbolVersion(h, version);
+    if(!symvername)
         return 0;
     return strcmp(vername, symvername)?0:1;
 }
@@ -84,7 +86,7 @@ static Elf32_Sym* old_elf_lookup(elfheader_t* h, const char* symname, int ver, c
     const uint32_t *buckets = &hashtab[2];
     const uint32_t *chains = &buckets[nbuckets];
     // get hash from symname to lookup
-    const uint32_t hash = old_elf_hash(symname);
+    const uint32_t hash = GetOldElfHash(symname);
     // Search for it
     for (uint32_t i = buckets[hash % nbuckets]; i; i = chains[i]) {
         const char* name = h->DynStr + h->DynSym._32[i].st_name;
@@ -128,7 +130,7 @@ static Elf32_Sym* new_elf_lookup(elfheader_t* h, const char* symname, int ver, c
     const uint32_t *buckets = (uint32_t*)&blooms[bloom_size];
     const uint32_t *chains = &buckets[nbuckets];
     // get hash from symname to lookup
-    const uint32_t hash = new_elf_hash(symname);
+    const uint32_t hash = GetNewElfHash(symname);
     // early check with bloom: if at least one bit is not set, a symbol is surely missing.
     uint32_t word = blooms[(hash/32)%bloom_size];
     uint32_t mask = 0
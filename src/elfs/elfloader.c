@@ -10,6 +10,7 @@
 #include <link.h>
 #include <unistd.h>
 #include <errno.h>
+#include <pthread.h>
 #ifndef _DLFCN_H
 #include <dlfcn.h>
 #endif
@@ -88,6 +89,8 @@ void FreeElfHeader(elfheader_t** head)
     box_free(h->DynStr);
     box_free(h->SymTab._64);
     box_free(h->DynSym._64);
+    box_free(h->symindex);
+    FreeRelocCacheDeps(h);
 
     FreeElfMemory(h);
 
@@ -416,6 +419,10 @@ int AllocLoadElfMemory(box64context_t* context, elfheader_t* head, int mainbin)
     fclose(head->file);
     head->file = NULL;
     head->fileno = -1;
+    BuildElfSymIndex(head);
+    // main elf is already in the elf collection
+    if(getElfIndex(context, head)!=-1)
+        RefreshElfRanges(context);
 
     return 0;
 }
@@ -551,17 +558,22 @@ static void GrabX64CopyMainElfReloc(elfheader_t* head)
     }
 }
 
+// protects what relocations share between elfs, as several elfs can be relocated at the same time (BOX64_RELOC_THREADS)
+static pthread_mutex_t mutex_reloc = PTHREAD_MUTEX_INITIALIZER;
+
 static elfheader_t* checkElfLib(elfheader_t* h, library_t* lib)
 {
     if(h && lib) {
+        pthread_mutex_lock(&mutex_reloc);
         if(!h->needed)
             h->needed = new_neededlib(1);
         add1libref_neededlib(h->needed, lib);
+        pthread_mutex_unlock(&mutex_reloc);
     }
     return h;
 }
 
-static int RelocateElfRELA(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbind, elfheader_t* head, int cnt, Elf64_Rela *rela, int* need_resolv)
+static int RelocateElfRELA(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbind, elfheader_t* head, int cnt, Elf64_Rela *rela, int* need_resolv, reloccache_t* rc)
 {
     int ret_ok = 0;
     for (int i=0; i<cnt; ++i) {
@@ -608,13 +620,14 @@ static int RelocateElfRELA(lib_t *maplib, lib_t *local_maplib, int bindnow, int
                     if(!offs && !end && local_maplib && !deepbind)
                         GetLocalSymbolStartEnd(local_maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym);
                 }
-            } else {
+            } else if(!(elfsym = RelocCacheGet(rc, i, symname, &offs, &end))) {
                 if(!offs && !end && local_maplib && deepbind)
                     GetGlobalSymbolStartEnd(local_maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym);
                 if(!offs && !end)
                     GetGlobalSymbolStartEnd(maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym);
                 if(!offs && !end && local_maplib && !deepbind)
                     GetGlobalSymbolStartEnd(local_maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym);
+                RelocCacheSet(rc, i, elfsym, offs, end);
             }
         }
         sym_elf = FindElfSymbol(my_context, elfsym);
@@ -800,8 +813,10 @@ static int RelocateElfRELA(lib_t *maplib, lib_t *local_maplib, int bindnow, int
                 if(!symname || !symname[0]) {
                     printf_dump(LOG_NEVER, "Apply %s R_X86_64_TLSDESC @%p with addend=%zu\n", BindSym(bind), p, rela[i].r_addend);
                     struct tlsdesc volatile *td = (struct tlsdesc volatile *)p;
+                    pthread_mutex_lock(&mutex_reloc);
                     if(!tlsdescUndefweak)
                         tlsdescUndefweak = AddBridge(my_context->system, pFE, my__dl_tlsdesc_undefweak, 0, "_dl_tlsdesc_undefweak");
+                    pthread_mutex_unlock(&mutex_reloc);
                     td->entry = tlsdescUndefweak;
                     td->arg = (uintptr_t)(head->tlsbase + rela[i].r_addend);
                 } else {
@@ -865,11 +880,39 @@ int RelocateElf64(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbind,
         int cnt = head->relasz / head->relaent;
         DumpRelATable64(head, cnt, (Elf64_Rela *)(head->rela + head->delta), "RelA");
         printf_dump(LOG_DEBUG, "Applying %d Relocation(s) with Addend for %s bindnow=%d, deepbind=%d\n", cnt, head->name, bindnow, deepbind);
-        if(RelocateElfRELA(maplib, local_maplib, bindnow, deepbind, head, cnt, (Elf64_Rela *)(head->rela + head->delta), NULL))
+        reloccache_t* rc = OpenRelocCache(maplib, local_maplib, deepbind, head, "rela", cnt);
+        int ret = RelocateElfRELA(maplib, local_maplib, bindnow, deepbind, head, cnt, (Elf64_Rela *)(head->rela + head->delta), NULL, rc);
+        CloseRelocCache(rc);
+        if(ret)
             return -1;
     }
     return 0;
 }
+static int IndependentRELA(Elf64_Rela* rela, int cnt)
+{
+    for(int i=0; i<cnt; ++i)
+        switch(ELF64_R_TYPE(rela[i].r_info)) {
+            case R_X86_64_IRELATIVE:    // run guest code
+            case R_X86_64_COPY:         // read the data of another elf, that may be under relocation
+                return 0;
+        }
+    return 1;
+}
+static int ElfRelocIsIndependent64(elfheader_t* head)
+{
+    if(head->rel || (head->pltrel && head->pltrel!=DT_RELA))
+        return 0;
+    if(head->rela && !IndependentRELA((Elf64_Rela *)(head->rela + head->delta), head->relasz / head->relaent))
+        return 0;
+    if(head->pltrel && !IndependentRELA((Elf64_Rela *)(head->jmprel + head->delta), head->pltsz / head->pltent))
+        return 0;
+    return 1;
+}
+int ElfRelocIsIndependent(elfheader_t* head)
+{
+    return box64_is32bits?0:ElfRelocIsIndependent64(head);   // 32bits elfs are always relocated serially
+}
+
 int RelocateElf(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbind, elfheader_t* head)
 {
     return box64_is32bits?RelocateElf32(maplib, local_maplib, bindnow, deepbind, head):RelocateElf64(maplib, local_maplib, bindnow, deepbind, head);
@@ -898,13 +941,18 @@ int RelocateElfPlt64(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbi
         } else if(head->pltrel==DT_RELA) {
             DumpRelATable64(head, cnt, (Elf64_Rela *)(head->jmprel + head->delta), "PLT");
             printf_dump(LOG_DEBUG, "Applying %d PLT Relocation(s) with Addend for %s bindnow=%d, deepbind=%d\n", cnt, head->name, bindnow, deepbind);
-            if(RelocateElfRELA(maplib, local_maplib, bindnow, deepbind, head, cnt, (Elf64_Rela *)(head->jmprel + head->delta), &need_resolver))
+            reloccache_t* rc = OpenRelocCache(maplib, local_maplib, deepbind, head, "plt", cnt);
+            int ret = RelocateElfRELA(maplib, local_maplib, bindnow, deepbind, head, cnt, (Elf64_Rela *)(head->jmprel + head->delta), &need_resolver, rc);
+            CloseRelocCache(rc);
+            if(ret)
                 return -1;
         }
         if(need_resolver) {
+            pthread_mutex_lock(&mutex_reloc);
             if(pltResolver64==(uintptr_t)-1) {
                 pltResolver64 = AddBridge(my_context->system, vFE, PltResolver64, 0, "PltResolver");
             }
+            pthread_mutex_unlock(&mutex_reloc);
             if(head->pltgot) {
                 *(uintptr_t*)(head->pltgot+head->delta+16) = pltResolver64;
                 *(uintptr_t*)(head->pltgot+head->delta+8) = (uintptr_t)head;
@@ -916,6 +964,7 @@ int RelocateElfPlt64(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbi
             }
         }
     }
+    FreeRelocCacheDeps(head);   // plt is relocated last
    
     return 0;
 }
@@ -958,6 +1007,7 @@ uintptr_t GetLastByte(elfheader_t* h)
 #endif
 
 void checkHookedSymbols(elfheader_t* h); // in mallochook.c
+void checkStringSymbols(elfheader_t* h); // in stringhook.c
 void AddSymbols32(lib_t *maplib, elfheader_t* h)
 #ifndef BOX32
 { }
@@ -977,6 +1027,7 @@ void AddSymbols(lib_t *maplib, elfheader_t* h)
     }
     #ifndef STATICBUILD
     checkHookedSymbols(h);
+    checkStringSymbols(h);
     #endif
 }
 extern path_collection_t box64_addlibs;
@@ -1285,20 +1336,126 @@ int IsAddressInElfSpace(const elfheader_t* h, uintptr_t addr)
     }
     return 0;
 }
-elfheader_t* FindElfAddress(box64context_t *context, uintptr_t addr)
+static int compare_elfrange(const void* a, const void* b)
+{
+    const elfrange_t* ra = a;
+    const elfrange_t* rb = b;
+    if(ra->start!=rb->start)
+        return (ra->start<rb->start)?-1:1;
+    return 0;
+}
+
+void RefreshElfRanges(box64context_t *context)
 {
+    // build a new address sorted snapshot of all the elf blocks, and publish it
+    // the old snapshots are freed only if no FindElfAddress is running, as they might still be read
+    int n = 0;
     for (int i=0; i<context->elfsize; ++i)
-        if(IsAddressInElfSpace(context->elfs[i], addr))
-            return context->elfs[i];
-    
-    return NULL;
+        if(context->elfs[i])
+            n += context->elfs[i]->multiblock_n;
+    elfranges_t* ranges = (elfranges_t*)box_calloc(1, sizeof(elfranges_t)+n*sizeof(elfrange_t));
+    for (int i=0; i<context->elfsize; ++i) {
+        elfheader_t* h = context->elfs[i];
+        if(!h || !h->multiblocks)
+            continue;
+        for(int j=0; j<h->multiblock_n; ++j)
+            if(h->multiblocks[j].p) {
+                ranges->ranges[ranges->size].start = (uintptr_t)h->multiblocks[j].p;
+                ranges->ranges[ranges->size].end = (uintptr_t)h->multiblocks[j].p + h->multiblocks[j].asize - 1;
+                ranges->ranges[ranges->size].h = h;
+                ++ranges->size;
+            }
+    }
+    qsort(ranges->ranges, ranges->size, sizeof(elfrange_t), compare_elfrange);
+    ranges->old = __atomic_exchange_n(&context->elfranges, ranges, __ATOMIC_SEQ_CST);
+    // a reader starting now will get the new snapshot
+    if(!__atomic_load_n(&context->elfranges_readers, __ATOMIC_SEQ_CST)) {
+        elfranges_t* old = ranges->old;
+        ranges->old = NULL;
+        while(old) {
+            elfranges_t* next = old->old;
+            box_free(old);
+            old = next;
+        }
+    }
+}
+
+void FreeElfRanges(box64context_t *context)
+{
+    elfranges_t* ranges = __atomic_exchange_n(&context->elfranges, NULL, __ATOMIC_ACQ_REL);
+    while(ranges) {
+        elfranges_t* old = ranges->old;
+        box_free(ranges);
+        ranges = old;
+    }
+}
+
+elfheader_t* FindElfAddress(box64context_t *context, uintptr_t addr)
+{
+    elfheader_t* ret = NULL;
+    __atomic_add_fetch(&context->elfranges_readers, 1, __ATOMIC_SEQ_CST);
+    elfranges_t* ranges = __atomic_load_n(&context->elfranges, __ATOMIC_SEQ_CST);
+    // dichotomy search of the last range starting before addr
+    int imin = 0;
+    int imax = ranges?(ranges->size-1):-1;
+    while(imin<=imax) {
+        int i = (imin+imax)/2;
+        if(ranges->ranges[i].start>addr)
+            imax = i-1;
+        else if(ranges->ranges[i].end<addr)
+            imin = i+1;
+        else {
+            ret = ranges->ranges[i].h;
+            break;
+        }
+    }
+    __atomic_sub_fetch(&context->elfranges_readers, 1, __ATOMIC_SEQ_CST);
+    return ret;
+}
+
+static int compare_elfsymidx(const void* a, const void* b)
+{
+    const elfsymidx_t* sa = a;
+    const elfsymidx_t* sb = b;
+    if(sa->offs!=sb->offs)
+        return (sa->offs<sb->offs)?-1:1;
+    if(sa->dyn!=sb->dyn)
+        return (sa->dyn<sb->dyn)?-1:1;
+    if(sa->idx!=sb->idx)
+        return (sa->idx<sb->idx)?-1:1;
+    return 0;
+}
+
+void BuildElfSymIndex(elfheader_t* h)
+{
+    // done at load time, as FindNearestSymbolName can be called from the signal handler
+    if(h->symindex)
+        return;
+    size_t n = h->numSymTab + h->numDynSym;
+    elfsymindex_t* index = (elfsymindex_t*)box_malloc(sizeof(elfsymindex_t)+n*sizeof(elfsymidx_t));
+    if(!index)
+        return; // FindNearestSymbolName will do a linear search
+    index->size = n;
+    elfsymidx_t* s = index->syms;
+    for (size_t i=0; i<h->numSymTab; ++i, ++s) {
+        s->offs = box64_is32bits?h->SymTab._32[i].st_value:h->SymTab._64[i].st_value;
+        s->idx = i;
+        s->dyn = 0;
+    }
+    for (size_t i=0; i<h->numDynSym; ++i, ++s) {
+        s->offs = box64_is32bits?h->DynSym._32[i].st_value:h->DynSym._64[i].st_value;
+        s->idx = i;
+        s->dyn = 1;
+    }
+    // same address: SymTab first, then lowest index, to get the same result as a linear search
+    qsort(index->syms, n, sizeof(elfsymidx_t), compare_elfsymidx);
+    __atomic_store_n(&h->symindex, index, __ATOMIC_RELEASE);
 }
 
 const char* FindNearestSymbolName(elfheader_t* h, void* p, uintptr_t* start, uint64_t* sz)
 {
     uintptr_t addr = (uintptr_t)p;
 
-    uint32_t distance = 0x7fffffff;
     const char* ret = NULL;
     uintptr_t s = 0;
     uint64_t size = 0;
@@ -1322,31 +1479,69 @@ const char* FindNearestSymbolName(elfheader_t* h, void* p, uintptr_t* start, uin
     if(!h || h->fini_done)
         return ret;
 
-    for (size_t i=0; i<h->numSymTab && distance!=0; ++i) {
-        const char * symname = box64_is32bits?(h->StrTab+h->SymTab._32[i].st_name):(h->StrTab+h->SymTab._64[i].st_name);
-        uintptr_t offs = (box64_is32bits?h->SymTab._32[i].st_value:h->SymTab._64[i].st_value) + h->delta;
-
-        if(offs<=addr) {
-            if(distance>addr-offs) {
-                distance = addr-offs;
-                ret = symname;
-                s = offs;
-                size = box64_is32bits?h->SymTab._32[i].st_size:h->SymTab._64[i].st_size;
+    elfsymindex_t* index = __atomic_load_n(&h->symindex, __ATOMIC_ACQUIRE);
+    if(!index) {
+        // no index (yet), linear search
+        uint32_t distance = 0x7fffffff;
+        for (size_t i=0; i<h->numSymTab && distance!=0; ++i) {
+            const char * symname = box64_is32bits?(h->StrTab+h->SymTab._32[i].st_name):(h->StrTab+h->SymTab._64[i].st_name);
+            uintptr_t offs = (box64_is32bits?h->SymTab._32[i].st_value:h->SymTab._64[i].st_value) + h->delta;
+
+            if(offs<=addr) {
+                if(distance>addr-offs) {
+                    distance = addr-offs;
+                    ret = symname;
+                    s = offs;
+                    size = box64_is32bits?h->SymTab._32[i].st_size:h->SymTab._64[i].st_size;
+                }
             }
         }
-    }
-    for (size_t i=0; i<h->numDynSym && distance!=0; ++i) {
-        const char * symname = h->DynStr+(box64_is32bits?h->DynSym._32[i].st_name:h->DynSym._64[i].st_name);
-        uintptr_t offs = (box64_is32bits?h->DynSym._32[i].st_value:h->DynSym._64[i].st_value) + h->delta;
-
-        if(offs<=addr) {
-            if(distance>addr-offs) {
-                distance = addr-offs;
-                ret = symname;
-                s = offs;
-                size = box64_is32bits?h->DynSym._32[i].st_size:h->DynSym._64[i].st_size;
+        for (size_t i=0; i<h->numDynSym && distance!=0; ++i) {
+            const char * symname = h->DynStr+(box64_is32bits?h->DynSym._32[i].st_name:h->DynSym._64[i].st_name);
+            uintptr_t offs = (box64_is32bits?h->DynSym._32[i].st_value:h->DynSym._64[i].st_value) + h->delta;
+
+            if(offs<=addr) {
+                if(distance>addr-offs) {
+                    distance = addr-offs;
+                    ret = symname;
+                    s = offs;
+                    size = box64_is32bits?h->DynSym._32[i].st_size:h->DynSym._64[i].st_size;
+                }
             }
         }
+        if(start)
+            *start = s;
+        if(sz)
+            *sz = size;
+        return ret;
+    }
+    // dichotomy search of the last symbol at or before addr
+    uintptr_t target = addr - h->delta;
+    ssize_t imin = 0;
+    ssize_t imax = (ssize_t)index->size-1;
+    ssize_t k = -1;
+    while(imin<=imax) {
+        ssize_t i = (imin+imax)/2;
+        if(index->syms[i].offs<=target) {
+            k = i;
+            imin = i+1;
+        } else
+            imax = i-1;
+    }
+    // only symbols closer than 2G are considered, like before
+    if(k>=0 && (target-index->syms[k].offs)<0x7fffffff) {
+        // rewind to the 1st symbol with the same address
+        while(k && index->syms[k-1].offs==index->syms[k].offs)
+            --k;
+        uint32_t i = index->syms[k].idx;
+        if(index->syms[k].dyn) {
+            ret = h->DynStr+(box64_is32bits?h->DynSym._32[i].st_name:h->DynSym._64[i].st_name);
+            size = box64_is32bits?h->DynSym._32[i].st_size:h->DynSym._64[i].st_size;
+        } else {
+            ret = h->StrTab+(box64_is32bits?h->SymTab._32[i].st_name:h->SymTab._64[i].st_name);
+            size = box64_is32bits?h->SymTab._32[i].st_size:h->SymTab._64[i].st_size;
+        }
+        s = index->syms[k].offs + h->delta;
     }
 
     if(start)
@@ -1374,7 +1569,10 @@ const char* VersionedName(const char* name, int ver, const char* vername)
     strcpy(buf, name);
     strcat(buf, "@");
     strcat(buf, v);
-    return AddDictionnary(my_context->versym, buf);
+    pthread_mutex_lock(&mutex_reloc);
+    const char* ret = AddDictionnary(my_context->versym, buf);
+    pthread_mutex_unlock(&mutex_reloc);
+    return ret;
 }
 
 int SameVersionedSymbol(const char* name1, int ver1, const char* vername1, int veropt1, const char* name2, int ver2, const char* vername2, int veropt2)
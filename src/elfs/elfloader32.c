@@ -330,6 +330,10 @@ int AllocLoadElfMemory32(box64context_t* context, elfheader_t* head, int mainbin
     fclose(head->file);
     head->file = NULL;
     head->fileno = -1;
+    BuildElfSymIndex(head);
+    // main elf is already in the elf collection
+    if(getElfIndex(context, head)!=-1)
+        RefreshElfRanges(context);
 
     return 0;
 }
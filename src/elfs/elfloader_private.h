@@ -19,6 +19,29 @@ typedef struct multiblock_s {
     uint8_t     flags;
 } multiblock_t;
 
+typedef struct elfsymidx_s {
+    uintptr_t   offs;   // st_value of the symbol (delta not applied)
+    uint32_t    idx;    // index in SymTab or DynSym
+    uint32_t    dyn;    // 0: SymTab, 1: DynSym
+} elfsymidx_t;
+
+typedef struct elfsymindex_s {
+    size_t      size;
+    elfsymidx_t syms[];
+} elfsymindex_t;
+
+typedef struct elfrange_s {
+    uintptr_t   start;
+    uintptr_t   end;    // last byte of the range
+    elfheader_t* h;
+} elfrange_t;
+
+typedef struct elfranges_s {
+    struct elfranges_s* old;    // previous snapshots, freed on a refresh with no reader
+    int         size;
+    elfrange_t  ranges[];
+} elfranges_t;
+
 typedef struct elfheader_s {
     char*       name;
     char*       path;   // Resolved path to file
@@ -132,6 +155,8 @@ typedef struct elfheader_s {
     char*       memory;     // char* and not void* to allow math on memory pointer
     multiblock_t*  multiblocks;
     int         multiblock_n;
+    elfsymindex_t* symindex;    // built at load time, address sorted SymTab+DynSym, for FindNearestSymbolName
+    struct reloccache_deps_s* relocdeps;    // fingerprint for the relocation caches, kept from the rela to the plt relocation
 
     library_t   *lib;       // attached lib (exept on main elf)
     needed_libs_t* needed;
@@ -214,6 +239,9 @@ uint16_t GetSymbolVersionFlag(elfheader_t* h, int index);
 
 uint32_t old_elf_hash(const char* name);
 uint32_t new_elf_hash(const char *name);
+// same as above, but reuse the hash of the name pushed with PushSymbolHash if it's the one asked
+uint32_t GetOldElfHash(const char* name);
+uint32_t GetNewElfHash(const char* name);
 
 Elf32_Sym* ElfLookup32(elfheader_t* h, const char* symname, int ver, const char* vername, int local, int veropt);
 Elf32_Sym* ElfSymTabLookup32(elfheader_t* h, const char* symname);
@@ -223,4 +251,12 @@ Elf64_Sym* ElfLookup64(elfheader_t* h, const char* symname, int ver, const char*
 Elf64_Sym* ElfSymTabLookup64(elfheader_t* h, const char* symname);
 Elf64_Sym* ElfDynSymLookup64(elfheader_t* h, const char* symname);
 
+// persistent cache of the symbol bindings of relocations (BOX64_RELOCCACHE)
+typedef struct reloccache_s reloccache_t;
+reloccache_t* OpenRelocCache(lib_t* maplib, lib_t* local_maplib, int deepbind, elfheader_t* head, const char* kind, int cnt);
+Elf64_Sym* RelocCacheGet(reloccache_t* rc, int i, const char* symname, uintptr_t* offs, uintptr_t* end);
+void RelocCacheSet(reloccache_t* rc, int i, Elf64_Sym* elfsym, uintptr_t offs, uintptr_t end);
+void CloseRelocCache(reloccache_t* rc);
+void FreeRelocCacheDeps(elfheader_t* head);
+
 #endif //__ELFLOADER_PRIVATE_H_
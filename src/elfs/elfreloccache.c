@@ -0,0 +1,293 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <elf.h>
+#include <link.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "custommem.h"
+#include "debug.h"
+#include "box64context.h"
+#include "elfloader.h"
+#include "elfload_dump.h"
+#include "elfloader_private.h"
+#include "librarian.h"
+#include "librarian/librarian_private.h"
+#include "library.h"
+#include "librarian/library_private.h"
+#include "fileutils.h"
+
+// On-disk cache of the symbol bindings done by RelocateElfRELA.
+// A cache file is keyed on the identity (path, device, inode, size, mtime) of box64, of the relocated elf
+// and of every library that can be searched (in search order), so a cache hit means the symbol search
+// would give the same result. Only bindings to emulated elfs are stored (as elf index + symbol index),
+// bindings to wrapped libs need bridges and are always searched.
+
+#define RELOCCACHE_MAGIC    0x31435242  // "BRC1"
+
+typedef struct reloccache_entry_s {
+    int32_t     elf;    // index in reloccache_t.elfs, -1 if not cached
+    uint32_t    sym;    // index in the DynSym of that elf
+} reloccache_entry_t;
+
+typedef struct reloccache_header_s {
+    uint32_t    magic;
+    uint32_t    cnt;
+    uint64_t    key;
+} reloccache_header_t;
+
+// fingerprint of box64, the elf and the libs it can bind to, computed once for the rela and the plt caches of an elf
+typedef struct reloccache_deps_s {
+    uint64_t            key;
+    lib_t*              maplib;     // the search context it was computed for
+    lib_t*              local_maplib;
+    int                 maplib_sz;
+    int                 local_maplib_sz;
+    int                 deepbind;
+    int                 nelfs;
+    int                 capelfs;
+    elfheader_t**       elfs;
+} reloccache_deps_t;
+
+typedef struct reloccache_s {
+    char*               path;
+    uint64_t            key;
+    int                 dirty;
+    reloccache_deps_t*  deps;
+    int                 cnt;
+    reloccache_entry_t  entries[];
+} reloccache_t;
+
+static uint64_t rc_hash(uint64_t h, const void* p, size_t l)
+{
+    // FNV-1a
+    const uint8_t* s = (const uint8_t*)p;
+    for(size_t i=0; i<l; ++i) {
+        h ^= s[i];
+        h *= 0x100000001b3LL;
+    }
+    return h;
+}
+
+static uint64_t rc_hashfile(uint64_t h, const char* path)
+{
+    struct stat st;
+    if(!path || stat(path, &st))
+        return rc_hash(h, "?", 1);
+    h = rc_hash(h, path, strlen(path)+1);
+    h = rc_hash(h, &st.st_dev, sizeof(st.st_dev));
+    h = rc_hash(h, &st.st_ino, sizeof(st.st_ino));
+    h = rc_hash(h, &st.st_size, sizeof(st.st_size));
+    h = rc_hash(h, &st.st_mtim, sizeof(st.st_mtim));
+    return h;
+}
+
+static uint64_t rc_hashlib(reloccache_deps_t* rc, uint64_t h, library_t* lib)
+{
+    if(!lib)
+        return rc_hash(h, "-", 1);
+    elfheader_t* elf = GetElf(lib);
+    if(elf) {
+        if(rc->nelfs==rc->capelfs) {
+            rc->capelfs += 16;
+            rc->elfs = (elfheader_t**)box_realloc(rc->elfs, rc->capelfs*sizeof(elfheader_t*));
+        }
+        rc->elfs[rc->nelfs++] = elf;
+        h = rc_hash(h, "e", 1);
+        return rc_hashfile(h, ElfPath(elf));
+    }
+    h = rc_hash(h, "w", 1);
+    h = rc_hash(h, lib->name, strlen(lib->name)+1);
+    #ifndef STATICBUILD
+    // symbols exposed by a wrapped lib depend on the native lib behind it
+    struct link_map* lm = NULL;
+    if(lib->type==LIB_WRAPPED && lib->w.lib && !dlinfo(lib->w.lib, RTLD_DI_LINKMAP, &lm) && lm)
+        h = rc_hashfile(h, lm->l_name);
+    #endif
+    return h;
+}
+
+static uint64_t rc_hashmaplib(reloccache_deps_t* rc, uint64_t h, lib_t* maplib)
+{
+    if(!maplib)
+        return rc_hash(h, "0", 1);
+    h = rc_hash(h, &maplib->libsz, sizeof(maplib->libsz));
+    for(int i=0; i<maplib->libsz; ++i)
+        h = rc_hashlib(rc, h, maplib->libraries[i]);
+    return h;
+}
+
+static void rc_dir(char* dir, size_t sz)
+{
+    const char* p = getenv("XDG_CACHE_HOME");
+    if(p && p[0])
+        snprintf(dir, sz, "%s/box64", p);
+    else if((p = getenv("HOME")) && p[0])
+        snprintf(dir, sz, "%s/.cache/box64", p);
+    else
+        snprintf(dir, sz, "%s/box64-cache", GetTmpDir());
+}
+
+static int rc_depsvalid(reloccache_deps_t* d, lib_t* maplib, lib_t* local_maplib, int deepbind)
+{
+    return d && d->maplib==maplib && d->local_maplib==local_maplib && d->deepbind==deepbind
+        && d->maplib_sz==(maplib?maplib->libsz:0) && d->local_maplib_sz==(local_maplib?local_maplib->libsz:0);
+}
+
+static reloccache_deps_t* rc_getdeps(lib_t* maplib, lib_t* local_maplib, int deepbind, elfheader_t* head)
+{
+    if(rc_depsvalid(head->relocdeps, maplib, local_maplib, deepbind))
+        return head->relocdeps;
+    FreeRelocCacheDeps(head);
+    reloccache_deps_t* rc = (reloccache_deps_t*)box_calloc(1, sizeof(reloccache_deps_t));
+    rc->maplib = maplib;
+    rc->local_maplib = local_maplib;
+    rc->maplib_sz = maplib?maplib->libsz:0;
+    rc->local_maplib_sz = local_maplib?local_maplib->libsz:0;
+    rc->deepbind = deepbind;
+    uint64_t h = 0xcbf29ce484222325LL;
+    h = rc_hash(h, &deepbind, sizeof(deepbind));
+    h = rc_hashfile(h, my_context->box64path);
+    h = rc_hashfile(h, ElfPath(head));
+    // same search order as in the librarian: preload, main elf, maplib, local_maplib
+    if(my_context->preload) {
+        h = rc_hash(h, &my_context->preload->size, sizeof(my_context->preload->size));
+        for(int i=0; i<my_context->preload->size; ++i)
+            h = rc_hashlib(rc, h, my_context->preload->libs[i]);
+    }
+    if(rc->nelfs==rc->capelfs) {
+        rc->capelfs += 16;
+        rc->elfs = (elfheader_t**)box_realloc(rc->elfs, rc->capelfs*sizeof(elfheader_t*));
+    }
+    rc->elfs[rc->nelfs++] = my_context->elfs[0];
+    h = rc_hashfile(h, ElfPath(my_context->elfs[0]));
+    h = rc_hashmaplib(rc, h, maplib);
+    h = rc_hashmaplib(rc, h, local_maplib);
+    rc->key = h;
+    head->relocdeps = rc;
+    return rc;
+}
+
+void FreeRelocCacheDeps(elfheader_t* head)
+{
+    if(!head->relocdeps)
+        return;
+    box_free(head->relocdeps->elfs);
+    box_free(head->relocdeps);
+    head->relocdeps = NULL;
+}
+
+reloccache_t* OpenRelocCache(lib_t* maplib, lib_t* local_maplib, int deepbind, elfheader_t* head, const char* kind, int cnt)
+{
+    if(!box64_reloc_cache || !cnt || box64_is32bits)
+        return NULL;
+    reloccache_t* rc = (reloccache_t*)box_calloc(1, sizeof(reloccache_t)+cnt*sizeof(reloccache_entry_t));
+    rc->cnt = cnt;
+    rc->deps = rc_getdeps(maplib, local_maplib, deepbind, head);
+    uint64_t h = rc->deps->key;
+    h = rc_hash(h, kind, strlen(kind)+1);
+    h = rc_hash(h, &cnt, sizeof(cnt));
+    rc->key = h;
+    char dir[4096];
+    char path[4096+32];
+    rc_dir(dir, sizeof(dir));
+    snprintf(path, sizeof(path), "%s/reloc-%016lx", dir, h);
+    rc->path = box_strdup(path);
+    // try to load the cache file
+    int ok = 0;
+    int fd = open(rc->path, O_RDONLY|O_CLOEXEC);
+    if(fd!=-1) {
+        reloccache_header_t hdr;
+        size_t sz = cnt*sizeof(reloccache_entry_t);
+        if(read(fd, &hdr, sizeof(hdr))==sizeof(hdr) && hdr.magic==RELOCCACHE_MAGIC && hdr.cnt==(uint32_t)cnt && hdr.key==h
+          && read(fd, rc->entries, sz)==(ssize_t)sz)
+            ok = 1;
+        close(fd);
+    }
+    if(ok) {
+        printf_log(LOG_DEBUG, "Using relocation cache %s for %s (%s)\n", rc->path, ElfName(head), kind);
+    } else {
+        for(int i=0; i<cnt; ++i)
+            rc->entries[i].elf = -1;
+        rc->dirty = 1;
+    }
+    return rc;
+}
+
+Elf64_Sym* RelocCacheGet(reloccache_t* rc, int i, const char* symname, uintptr_t* offs, uintptr_t* end)
+{
+    if(!rc || i>=rc->cnt || rc->entries[i].elf<0 || rc->entries[i].elf>=rc->deps->nelfs)
+        return NULL;
+    elfheader_t* h = rc->deps->elfs[rc->entries[i].elf];
+    if(!h || rc->entries[i].sym>=h->numDynSym)
+        return NULL;
+    Elf64_Sym* sym = &h->DynSym._64[rc->entries[i].sym];
+    const char* name = SymName64(h, sym);
+    if(!name || strcmp(name, symname))
+        return NULL;
+    *offs = sym->st_value + h->delta;
+    *end = *offs + sym->st_size;
+    return sym;
+}
+
+void RelocCacheSet(reloccache_t* rc, int i, Elf64_Sym* elfsym, uintptr_t offs, uintptr_t end)
+{
+    if(!rc || !rc->dirty || i>=rc->cnt || !elfsym)
+        return;
+    for(int j=0; j<rc->deps->nelfs; ++j) {
+        elfheader_t* h = rc->deps->elfs[j];
+        if(h && elfsym>=h->DynSym._64 && elfsym<h->DynSym._64+h->numDynSym) {
+            // only cache plain bindings, not the ones adjusted by the librarian ("_END" objects...)
+            if(offs!=elfsym->st_value+h->delta || end!=offs+elfsym->st_size)
+                return;
+            rc->entries[i].elf = j;
+            rc->entries[i].sym = elfsym - h->DynSym._64;
+            return;
+        }
+    }
+}
+
+void CloseRelocCache(reloccache_t* rc)
+{
+    if(!rc)
+        return;
+    if(rc->dirty) {
+        // write to a temporary file and rename it, so concurrent launches never see a partial file
+        char tmp[4096+64];
+        char dir[4096];
+        rc_dir(dir, sizeof(dir));
+        if(!FileExist(dir, 0)) {
+            char parent[4096];
+            snprintf(parent, sizeof(parent), "%s", dir);
+            char* s = strrchr(parent, '/');
+            if(s && s!=parent) {
+                *s = '\0';
+                mkdir(parent, 0755);
+            }
+            mkdir(dir, 0755);
+        }
+        snprintf(tmp, sizeof(tmp), "%s.%d", rc->path, getpid());
+        int fd = open(tmp, O_CREAT|O_TRUNC|O_WRONLY|O_CLOEXEC, 0644);
+        if(fd!=-1) {
+            reloccache_header_t hdr = {0};
+            hdr.magic = RELOCCACHE_MAGIC;
+            hdr.cnt = rc->cnt;
+            hdr.key = rc->key;
+            size_t sz = rc->cnt*sizeof(reloccache_entry_t);
+            int ok = (write(fd, &hdr, sizeof(hdr))==sizeof(hdr)) && (write(fd, rc->entries, sz)==(ssize_t)sz);
+            close(fd);
+            if(ok && !rename(tmp, rc->path))
+                printf_log(LOG_DEBUG, "Relocation cache %s written\n", rc->path);
+            else
+                unlink(tmp);
+        }
+    }
+    box_free(rc->path);
+    box_free(rc);
+}
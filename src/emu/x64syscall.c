@@ -20,6 +20,7 @@
 #include <sys/utsname.h>
 #include <sys/resource.h>
 #include <poll.h>
+#include <pthread.h>
 
 #include "debug.h"
 #include "box64stack.h"
@@ -62,6 +63,7 @@ void* my_mremap(x64emu_t* emu, void* old_addr, size_t old_size, size_t new_size,
 int32_t my_epoll_ctl(x64emu_t* emu, int32_t epfd, int32_t op, int32_t fd, void* event);
 int32_t my_epoll_wait(x64emu_t* emu, int32_t epfd, void* events, int32_t maxevents, int32_t timeout);
 int32_t my_epoll_pwait(x64emu_t* emu, int32_t epfd, void* events, int32_t maxevents, int32_t timeout, const sigset_t *sigmask);
+int32_t my_epoll_pwait2(x64emu_t* emu, int32_t epfd, void* events, int32_t maxevents, const struct timespec* timeout, const sigset_t* sigmask);
 #endif
 pid_t my_vfork(x64emu_t* emu);
 int32_t my_fcntl(x64emu_t* emu, int32_t a, int32_t b, void* c);
@@ -304,6 +306,9 @@ static const scwrap_t syscallwrap[] = {
     #ifdef __NR_fchmodat4
     [434] = {__NR_fchmodat4, 4},
     #endif
+    #if defined(__NR_epoll_pwait2) && defined(NOALIGN)
+    [441] = {__NR_epoll_pwait2, 6},
+    #endif
     #ifdef __NR_landlock_create_ruleset	
     [444] = {__NR_landlock_create_ruleset, 3},
     #endif
@@ -402,6 +407,360 @@ typedef struct old_utsname_s {
 //    int  xss;
 //};
 
+#if defined(__NR_io_uring_setup)
+/*
+    io_uring: the ring memory, SQE and CQE layouts are the same on all 64bits archs, so rings mmaped by the
+ guest are used as is. But a few opcodes carry a payload with an ABI difference:
+  - IORING_OP_EPOLL_CTL points to a struct epoll_event (packed on x86_64)
+  - IORING_OP_OPENAT / IORING_OP_OPENAT2 have O_xxx flags (values differ), and the path gets the same
+    /proc/self/exe redirection as the open wrappers
+ The rings are tracked (fd, offsets and mmaped addresses) so io_uring_enter can translate those SQEs just before
+ submission. The kernel reads the payloads while submitting, so the translated values only need to live during
+ the syscall, and the SQEs that were not consumed are restored after it.
+ Without the alignment fixes (NOALIGN), only the path of OPENAT / OPENAT2 is translated.
+ With IORING_SETUP_SQPOLL, the kernel consumes SQEs on its own and no translation is possible.
+*/
+#define X64_IORING_SETUP_SQPOLL         (1U<<1)
+#define X64_IORING_SETUP_SQE128         (1U<<10)
+#define X64_IORING_SETUP_NO_MMAP        (1U<<14)
+#define X64_IORING_SETUP_NO_SQARRAY     (1U<<16)
+#define X64_IORING_OFF_SQ_RING          0ULL
+#define X64_IORING_OFF_SQES             0x10000000ULL
+#define X64_IORING_ENTER_REGISTERED_RING (1U<<4)
+#define X64_IORING_REGISTER_RING_FDS    20
+#define X64_IORING_OP_OPENAT            18
+#define X64_IORING_OP_OPENAT2           28
+#define X64_IORING_OP_EPOLL_CTL         29
+#define X64_EPOLL_CTL_DEL               2
+
+typedef struct x64_io_sqring_offsets_s {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t ring_mask;
+    uint32_t ring_entries;
+    uint32_t flags;
+    uint32_t dropped;
+    uint32_t array;
+    uint32_t resv1;
+    uint64_t user_addr;
+} x64_io_sqring_offsets_t;
+
+typedef struct x64_io_cqring_offsets_s {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t ring_mask;
+    uint32_t ring_entries;
+    uint32_t overflow;
+    uint32_t cqes;
+    uint32_t flags;
+    uint32_t resv1;
+    uint64_t user_addr;
+} x64_io_cqring_offsets_t;
+
+typedef struct x64_io_uring_params_s {
+    uint32_t sq_entries;
+    uint32_t cq_entries;
+    uint32_t flags;
+    uint32_t sq_thread_cpu;
+    uint32_t sq_thread_idle;
+    uint32_t features;
+    uint32_t wq_fd;
+    uint32_t resv[3];
+    x64_io_sqring_offsets_t sq_off;
+    x64_io_cqring_offsets_t cq_off;
+} x64_io_uring_params_t;
+
+typedef struct x64_io_uring_sqe_s {
+    uint8_t  opcode;
+    uint8_t  flags;
+    uint16_t ioprio;
+    int32_t  fd;
+    uint64_t addr2;     // off
+    uint64_t addr;
+    uint32_t len;
+    uint32_t op_flags;  // open_flags...
+    uint64_t user_data;
+    // rest doesn't matter here
+} x64_io_uring_sqe_t;
+
+typedef struct iouring_slot_s {
+    uint64_t    payload[3];     // native epoll_event or open_how
+    uint64_t    old;            // original addr, addr2 or open flags
+    uint64_t    oldpath;        // original path of OPENAT/OPENAT2, 0 if not redirected
+    uint32_t    pos;            // position in the submitted range
+} iouring_slot_t;
+
+typedef struct iouring_slots_s {
+    int             refcnt;     // the ring, plus each io_uring_enter using it
+    uint32_t*       pending;    // index of the SQEs translated by the current io_uring_enter
+    iouring_slot_t  slots[];
+} iouring_slots_t;
+
+typedef struct iouring_s {
+    int             fd;
+    uint32_t        flags;
+    uint32_t        sq_entries;
+    x64_io_sqring_offsets_t sq_off;
+    void*           sq_ring;
+    void*           sqes;
+    iouring_slots_t* slots;
+    uint32_t        head;       // SQ head before the current io_uring_enter
+} iouring_t;
+
+#define MAX_IOURING 64
+static iouring_t* iourings[MAX_IOURING] = {0};
+static int iourings_used = 0;
+static pthread_mutex_t mutex_iouring = PTHREAD_MUTEX_INITIALIZER;
+
+void AlignEpollEvent(void* dest, void* source, int nbr);
+
+static iouring_t* iouring_find(int fd)
+{
+    for(int i=0; i<MAX_IOURING; ++i)
+        if(iourings[i] && iourings[i]->fd==fd)
+            return iourings[i];
+    return NULL;
+}
+
+static int iouring_isring(int fd)
+{
+    char path[64];
+    char buf[64];
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    ssize_t l = readlink(path, buf, sizeof(buf)-1);
+    if(l<=0)
+        return 0;
+    buf[l] = '\0';
+    return !strcmp(buf, "anon_inode:[io_uring]");
+}
+
+// need mutex_iouring
+static void iouring_slots_release(iouring_slots_t* s)
+{
+    if(s && !--s->refcnt)
+        box_free(s);
+}
+
+static int64_t my_io_uring_setup(x64emu_t* emu, uint32_t entries, x64_io_uring_params_t* p)
+{
+    (void)emu;
+    int64_t ret = syscall(__NR_io_uring_setup, entries, p);
+    if(ret<0)
+        return ret;
+    if(p->flags&X64_IORING_SETUP_SQPOLL)
+        printf_log(LOG_INFO, "Warning: io_uring ring %d uses SQPOLL, EPOLL_CTL and OPENAT SQEs will not be translated\n", (int)ret);
+    iouring_slots_t* slots = (iouring_slots_t*)box_calloc(1, sizeof(iouring_slots_t)+p->sq_entries*(sizeof(iouring_slot_t)+sizeof(uint32_t)));
+    slots->refcnt = 1;
+    slots->pending = (uint32_t*)&slots->slots[p->sq_entries];
+    pthread_mutex_lock(&mutex_iouring);
+    iouring_t* r = iouring_find(ret);   // fd reused, the old ring has been closed
+    if(!r) {
+        for(int i=0; i<MAX_IOURING && !r; ++i)
+            if(!iourings[i]) {
+                r = iourings[i] = (iouring_t*)box_calloc(1, sizeof(iouring_t));
+                __atomic_store_n(&iourings_used, 1, __ATOMIC_RELEASE);
+            }
+    }
+    if(!r) {
+        pthread_mutex_unlock(&mutex_iouring);
+        box_free(slots);
+        printf_log(LOG_INFO, "Warning: too many io_uring rings, SQEs of ring %d will not be translated\n", (int)ret);
+        return ret;
+    }
+    // the struct is never freed (a io_uring_enter could be using it), only reused
+    r->fd = ret;
+    r->flags = p->flags;
+    r->sq_off = p->sq_off;
+    r->sq_ring = NULL;
+    r->sqes = NULL;
+    // a io_uring_enter still running on the previous ring of this fd keeps its slots until it's done
+    iouring_slots_release(r->slots);
+    r->slots = slots;
+    r->sq_entries = p->sq_entries;
+    if(p->flags&X64_IORING_SETUP_NO_MMAP) {
+        // rings (including the SQ ring) and SQEs are in memory given by the guest
+        r->sq_ring = (void*)p->cq_off.user_addr;
+        r->sqes = (void*)p->sq_off.user_addr;
+    }
+    pthread_mutex_unlock(&mutex_iouring);
+    return ret;
+}
+
+void iouring_mmap(int fd, int64_t offset, void* addr)
+{
+    if(fd<0 || (offset!=X64_IORING_OFF_SQ_RING && offset!=X64_IORING_OFF_SQES) || !__atomic_load_n(&iourings_used, __ATOMIC_ACQUIRE))
+        return;
+    pthread_mutex_lock(&mutex_iouring);
+    iouring_t* r = iouring_find(fd);
+    if(r && iouring_isring(fd)) {
+        if(offset==X64_IORING_OFF_SQ_RING)
+            r->sq_ring = addr;
+        else
+            r->sqes = addr;
+    }
+    pthread_mutex_unlock(&mutex_iouring);
+}
+
+void iouring_munmap(void* addr, size_t length)
+{
+    if(!__atomic_load_n(&iourings_used, __ATOMIC_ACQUIRE))
+        return;
+    pthread_mutex_lock(&mutex_iouring);
+    for(int i=0; i<MAX_IOURING; ++i)
+        if(iourings[i]) {
+            iouring_t* r = iourings[i];
+            if(r->sq_ring>=addr && r->sq_ring<addr+length)
+                r->sq_ring = NULL;
+            if(r->sqes>=addr && r->sqes<addr+length)
+                r->sqes = NULL;
+        }
+    pthread_mutex_unlock(&mutex_iouring);
+}
+
+static int iouring_isprocexe(const char* path)
+{
+    if(!path || strncmp(path, "/proc/", 6))
+        return 0;
+    if(!strcmp(path, "/proc/self/exe"))
+        return 1;
+    char tmp[64];
+    snprintf(tmp, sizeof(tmp), "/proc/%d/exe", getpid());
+    return !strcmp(path, tmp);
+}
+
+// translate the SQEs that will be submitted, return the number of entries in r->slots->pending
+static uint32_t iouring_translate(iouring_t* r, uint32_t to_submit)
+{
+    uint8_t* ring = (uint8_t*)r->sq_ring;
+    uint32_t head = __atomic_load_n((uint32_t*)(ring+r->sq_off.head), __ATOMIC_ACQUIRE);
+    uint32_t tail = __atomic_load_n((uint32_t*)(ring+r->sq_off.tail), __ATOMIC_ACQUIRE);
+    uint32_t mask = *(uint32_t*)(ring+r->sq_off.ring_mask);
+    uint32_t* array = (r->flags&X64_IORING_SETUP_NO_SQARRAY)?NULL:(uint32_t*)(ring+r->sq_off.array);
+    size_t sqe_size = (r->flags&X64_IORING_SETUP_SQE128)?128:64;
+    uint32_t cnt = tail-head;
+    if(cnt>to_submit)
+        cnt = to_submit;
+    if(cnt>r->sq_entries)
+        cnt = r->sq_entries;
+    r->head = head;
+    uint32_t n = 0;
+    for(uint32_t i=0; i<cnt; ++i) {
+        uint32_t idx = array?array[(head+i)&mask]:((head+i)&mask);
+        if(idx>=r->sq_entries)
+            continue;   // invalid entry, the kernel will drop it
+        x64_io_uring_sqe_t* sqe = (x64_io_uring_sqe_t*)((uint8_t*)r->sqes+idx*sqe_size);
+        iouring_slot_t* slot = &r->slots->slots[idx];
+        slot->oldpath = 0;
+        switch(sqe->opcode) {
+            #ifndef NOALIGN
+            case X64_IORING_OP_EPOLL_CTL:
+                if(sqe->len==X64_EPOLL_CTL_DEL || !sqe->addr)
+                    continue;
+                AlignEpollEvent(slot->payload, (void*)sqe->addr, 1);
+                slot->old = sqe->addr;
+                sqe->addr = (uintptr_t)slot->payload;
+                break;
+            case X64_IORING_OP_OPENAT:
+                slot->old = sqe->op_flags;
+                sqe->op_flags = of_convert(sqe->op_flags);
+                break;
+            case X64_IORING_OP_OPENAT2:
+                if(sqe->addr2 && sqe->len>=sizeof(slot->payload)) {
+                    memcpy(slot->payload, (void*)sqe->addr2, sizeof(slot->payload));
+                    slot->payload[0] = (uint32_t)of_convert(slot->payload[0]);
+                    slot->old = sqe->addr2;
+                    sqe->addr2 = (uintptr_t)slot->payload;
+                } else
+                    slot->old = 0;
+                break;
+            #else
+            case X64_IORING_OP_OPENAT:
+            case X64_IORING_OP_OPENAT2:
+                break;  // only the path can need a translation
+            #endif
+            default:
+                continue;
+        }
+        if(sqe->opcode!=X64_IORING_OP_EPOLL_CTL && iouring_isprocexe((const char*)sqe->addr)) {
+            // the kernel copies the path while submitting
+            slot->oldpath = sqe->addr;
+            sqe->addr = (uintptr_t)my_context->fullpath;
+        }
+        #ifdef NOALIGN
+        else
+            continue;
+        #endif
+        slot->pos = i;
+        r->slots->pending[n++] = idx;
+    }
+    return n;
+}
+
+// put back the original values of the translated SQEs that were not consumed
+static void iouring_restore(iouring_t* r, uint32_t n)
+{
+    size_t sqe_size = (r->flags&X64_IORING_SETUP_SQE128)?128:64;
+    uint8_t* ring = (uint8_t*)r->sq_ring;
+    uint32_t consumed = __atomic_load_n((uint32_t*)(ring+r->sq_off.head), __ATOMIC_ACQUIRE) - r->head;
+    for(uint32_t i=0; i<n; ++i) {
+        uint32_t idx = r->slots->pending[i];
+        iouring_slot_t* slot = &r->slots->slots[idx];
+        if(slot->pos<consumed)
+            continue;
+        x64_io_uring_sqe_t* sqe = (x64_io_uring_sqe_t*)((uint8_t*)r->sqes+idx*sqe_size);
+        #ifndef NOALIGN
+        switch(sqe->opcode) {
+            case X64_IORING_OP_EPOLL_CTL: sqe->addr = slot->old; break;
+            case X64_IORING_OP_OPENAT: sqe->op_flags = slot->old; break;
+            case X64_IORING_OP_OPENAT2: if(slot->old) sqe->addr2 = slot->old; break;
+        }
+        #endif
+        if(slot->oldpath)
+            sqe->addr = slot->oldpath;
+    }
+}
+
+static int64_t my_io_uring_enter(x64emu_t* emu, int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags, void* sig, size_t sigsz)
+{
+    (void)emu;
+    iouring_t ring;
+    iouring_t* r = NULL;
+    if(to_submit && !(flags&X64_IORING_ENTER_REGISTERED_RING)) {
+        // work on a copy, a io_uring_setup reusing the fd can change the ring meanwhile
+        pthread_mutex_lock(&mutex_iouring);
+        iouring_t* found = iouring_find(fd);
+        if(found && found->sq_ring && found->sqes && found->slots && !(found->flags&X64_IORING_SETUP_SQPOLL)) {
+            ring = *found;
+            ++ring.slots->refcnt;
+            r = &ring;
+        }
+        pthread_mutex_unlock(&mutex_iouring);
+    }
+    // submission side of a ring is single producer: the guest serializes io_uring_enter with submissions for a ring
+    uint32_t n = r?iouring_translate(r, to_submit):0;
+    int64_t ret = syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, sig, sigsz);
+    if(n)
+        iouring_restore(r, n);
+    if(r) {
+        pthread_mutex_lock(&mutex_iouring);
+        iouring_slots_release(r->slots);
+        pthread_mutex_unlock(&mutex_iouring);
+    }
+    return ret;
+}
+
+static int64_t my_io_uring_register(x64emu_t* emu, int fd, uint32_t opcode, void* arg, uint32_t nr_args)
+{
+    (void)emu;
+    if(opcode==X64_IORING_REGISTER_RING_FDS) {
+        // enter with a registered ring index would bypass the SQE translation, liburing falls back to the plain fd
+        errno = EINVAL;
+        return -1;
+    }
+    return syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+#endif
+
 static int clone_fn(void* arg)
 {
     x64emu_t *emu = (x64emu_t*)arg;
@@ -414,6 +773,16 @@ static int clone_fn(void* arg)
     return ret;
 }
 
+// native syscall number of x86_64 syscall s if it can be forwarded as is, with nbpars arguments (0 if not)
+int GetNativeSyscall(uint32_t s, int* nbpars)
+{
+    uint32_t cnt = sizeof(syscallwrap) / sizeof(scwrap_t);
+    if(s>=cnt || !syscallwrap[s].nats)
+        return 0;
+    if(nbpars) *nbpars = syscallwrap[s].nbpars;
+    return syscallwrap[s].nats;
+}
+
 void EXPORT x64Syscall(x64emu_t *emu)
 {
     RESET_FLAGS(emu);
@@ -823,6 +1192,30 @@ void EXPORT x64Syscall(x64emu_t *emu)
                 S_RAX = -errno;
             break;
         #endif
+        #if defined(__NR_io_uring_setup)
+        case 425:   // sys_io_uring_setup
+            S_RAX = my_io_uring_setup(emu, R_EDI, (void*)R_RSI);
+            if(S_RAX==-1)
+                S_RAX = -errno;
+            break;
+        case 426:   // sys_io_uring_enter
+            S_RAX = my_io_uring_enter(emu, S_EDI, R_ESI, R_EDX, R_R10d, (void*)R_R8, R_R9);
+            if(S_RAX==-1)
+                S_RAX = -errno;
+            break;
+        case 427:   // sys_io_uring_register
+            S_RAX = my_io_uring_register(emu, S_EDI, R_ESI, (void*)R_RDX, R_R10d);
+            if(S_RAX==-1)
+                S_RAX = -errno;
+            break;
+        #endif
+        #ifndef NOALIGN
+        case 441:   // sys_epoll_pwait2
+            S_RAX = my_epoll_pwait2(emu, S_EDI, (void*)R_RSI, S_EDX, (void*)R_R10, (void*)R_R8);
+            if(S_RAX==-1)
+                S_RAX = -errno;
+            break;
+        #endif
         case 449:
             #ifdef __NR_futex_waitv
             if(box64_futex_waitv)
@@ -1099,6 +1492,18 @@ long EXPORT my_syscall(x64emu_t *emu)
         case 434:
             return fchmodat(S_ESI, (void*)R_RDX, (mode_t)R_RCX, S_R8d);
         #endif
+        #if defined(__NR_io_uring_setup)
+        case 425:   // sys_io_uring_setup
+            return my_io_uring_setup(emu, R_ESI, (void*)R_RDX);
+        case 426:   // sys_io_uring_enter
+            return my_io_uring_enter(emu, S_ESI, R_EDX, R_ECX, R_R8d, (void*)R_R9, i64(0));
+        case 427:   // sys_io_uring_register
+            return my_io_uring_register(emu, S_ESI, R_EDX, (void*)R_RCX, R_R8d);
+        #endif
+        #ifndef NOALIGN
+        case 441:   // sys_epoll_pwait2
+            return my_epoll_pwait2(emu, S_ESI, (void*)R_RDX, S_ECX, (void*)R_R8, (void*)R_R9);
+        #endif
         case 449:
             #ifdef __NR_futex_waitv
             if(box64_futex_waitv)
@@ -36,6 +36,7 @@ typedef struct linkmap_s linkmap_t;
 typedef struct linkmap32_s linkmap32_t;
 typedef struct kh_threadstack_s kh_threadstack_t;
 typedef struct rbtree rbtree;
+typedef struct elfranges_s elfranges_t;
 typedef struct atfork_fnc_s {
     uintptr_t prepare;
     uintptr_t parent;
@@ -126,6 +127,8 @@ typedef struct box64context_s {
     elfheader_t         **elfs;         // elf headers and memory
     int                 elfcap;
     int                 elfsize;        // number of elf loaded
+    elfranges_t         *elfranges;     // address sorted memory ranges of loaded elfs, for FindElfAddress
+    int                 elfranges_readers;  // FindElfAddress in progress, old elfranges are freed only when 0
 
 
     needed_libs_t       *neededlibs;    // needed libs for main elf
@@ -173,6 +176,7 @@ typedef struct box64context_s {
     #endif
     uintptr_t           max_db_size;    // the biggest (in x86_64 instructions bytes) built dynablock
     rbtree*             db_sizes;
+    rbtree*             db_strongmem;   // x64 code pages that needs strongmem (BOX64_DYNAREC_STRONGMEM_AUTO)
     int                 trace_dynarec;
     pthread_mutex_t     mutex_lock;     // this is for the Test interpreter
     #if defined(__riscv) || defined(__loongarch64)
@@ -31,6 +31,12 @@ extern uintptr_t box64_dynarec_test_start, box64_dynarec_test_end;
 extern int box64_dynarec_bigblock;
 extern int box64_dynarec_forward;
 extern int box64_dynarec_strongmem;
+extern int box64_dynarec_strongmem_auto;
+extern int box64_dynarec_rcpc;
+extern int box64_dynarec_sve;
+extern int box64_dynarec_nativeflags;
+extern int box64_dynarec_deadflags;
+extern int box64_dynarec_storefwd;
 extern int box64_dynarec_fastnan;
 extern int box64_dynarec_fastround;
 extern int box64_dynarec_x87double;
@@ -40,8 +46,10 @@ extern int box64_dynarec_callret;
 extern int box64_dynarec_bleeding_edge;
 extern int box64_dynarec_tbb;
 extern int box64_dynarec_wait;
+extern int box64_dynarec_syscall;
 extern int box64_dynarec_missing;
 extern int box64_dynarec_aligned_atomics;
+extern int box64_dynarec_perf_map;
 #ifdef ARM64
 extern int arm64_asimd;
 extern int arm64_aes;
@@ -51,10 +59,14 @@ extern int arm64_atomics;
 extern int arm64_sha1;
 extern int arm64_sha2;
 extern int arm64_uscat;
+extern int arm64_lrcpc;
+extern int arm64_lrcpc2;
 extern int arm64_flagm;
 extern int arm64_flagm2;
 extern int arm64_frintts;
 extern int arm64_rndr;
+extern int arm64_sve;
+extern int arm64_sve_vl;
 #elif defined(RV64)
 extern int rv64_zba;
 extern int rv64_zbb;
@@ -118,6 +130,9 @@ extern int box64_wine;
 extern int box64_musl;
 extern int box64_nopulse;   // disabling the use of wrapped pulseaudio
 extern int box64_nogtk; // disabling the use of wrapped gtk
+extern int box64_reloc_cache;  // persistent cache of relocation bindings
+extern int box64_reloc_threads;    // number of threads used to relocate needed libs
+extern int box64_native_strings;   // redirect x86_64 string variants of emulated libs to native libc
 extern int box64_novulkan;  // disabling the use of wrapped vulkan
 extern int box64_showsegv;  // show sigv, even if a signal handler is present
 extern int box64_showbt;    // show a backtrace if a signal is caught
@@ -25,6 +25,10 @@ int FreeRangeDynablock(dynablock_t* db, uintptr_t addr, uintptr_t size);
 void FreeInvalidDynablock(dynablock_t* db, int need_lock);
 dynablock_t* InvalidDynablock(dynablock_t* db, int need_lock);
 
+// x64 code pages that needs a strong memory model (BOX64_DYNAREC_STRONGMEM_AUTO), mutex_dyndump must be held
+int isStrongMemRange(uintptr_t addr, uintptr_t size);
+void addStrongMemPage(uintptr_t addr);
+
 dynablock_t* FindDynablockFromNativeAddress(void* addr);    // defined in box64context.h
 
 // Handling of Dynarec block (i.e. an exectable chunk of x64 translated code)
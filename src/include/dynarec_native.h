@@ -20,6 +20,7 @@ typedef struct instsize_s instsize_t;
 #endif
 
 #define MAX_INSTS   32760
+#define MAX_PEEK    64      // max bytes after the end of a block checked for flags liveness
 
 void addInst(instsize_t* insts, size_t* size, int x64_size, int native_size);
 
@@ -38,6 +38,20 @@ elfheader_t* LoadAndCheckElfHeader(FILE* f, const char* name, int exec); // exec
 void FreeElfHeader(elfheader_t** head);
 const char* ElfName(elfheader_t* head);
 const char* ElfPath(elfheader_t* head);
+
+// Hashes of a symbol name, shared by all elf lookups of that exact name pointer done by the current thread
+// between PushSymbolHash and PopSymbolHash (the name must not be modified in between)
+#define SYMHASH_SYSV    1
+#define SYMHASH_GNU     2
+typedef struct elfsymhash_s {
+    const char*             name;
+    uint32_t                sysv;
+    uint32_t                gnu;
+    int                     flags;
+    struct elfsymhash_s*    prev;
+} elfsymhash_t;
+void PushSymbolHash(elfsymhash_t* h, const char* name);
+void PopSymbolHash(elfsymhash_t* h);
 void ElfAttachLib(elfheader_t* head, library_t* lib);
 
 // return 0 if OK
@@ -47,6 +61,8 @@ void FreeElfMemory(elfheader_t* head);
 int isElfHasNeededVer(elfheader_t* head, const char* libname, elfheader_t* verneeded);
 int RelocateElf(lib_t *maplib, lib_t* local_maplib, int bindnow, int deepbind, elfheader_t* head);
 int RelocateElfPlt(lib_t *maplib, lib_t* local_maplib, int bindnow, int deepbind, elfheader_t* head);
+// 1 if the elf can be relocated while other elfs are being relocated (no COPY or IRELATIVE relocation)
+int ElfRelocIsIndependent(elfheader_t* head);
 void CalcStack(elfheader_t* h, uint64_t* stacksz, size_t* stackalign);
 uintptr_t GetEntryPoint(lib_t* maplib, elfheader_t* h);
 uintptr_t GetLastByte(elfheader_t* h);
@@ -64,6 +80,9 @@ void* GetElfDelta(elfheader_t* h);
 uint32_t GetBaseSize(elfheader_t* h);
 int IsAddressInElfSpace(const elfheader_t* h, uintptr_t addr);
 elfheader_t* FindElfAddress(box64context_t *context, uintptr_t addr);
+void RefreshElfRanges(box64context_t *context);    // to call each time an elf is added/removed/mapped
+void FreeElfRanges(box64context_t *context);
+void BuildElfSymIndex(elfheader_t* h);    // address sorted symbols for FindNearestSymbolName, built at load time
 const char* FindNearestSymbolName(elfheader_t* h, void* p, uintptr_t* start, uint64_t* sz);
 int32_t GetTLSBase(elfheader_t* h);
 uint32_t GetTLSSize(elfheader_t* h);
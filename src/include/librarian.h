@@ -17,6 +17,7 @@ typedef char* cstr_t;
 
 lib_t *NewLibrarian(box64context_t* context);
 void FreeLibrarian(lib_t **maplib, x64emu_t* emu);
+void NegCacheInvalidateAll(void);  // to call when the preloaded libs or the main elf change
 dlprivate_t *NewDLPrivate(void);
 void FreeDLPrivate(dlprivate_t **lib);
 
@@ -209,6 +209,10 @@ int of_unconvert(int);  // arm->x86
 void UnalignEpollEvent(void* dest, void* source, int nbr); // Arm -> x86
 void AlignEpollEvent(void* dest, void* source, int nbr); // x86 -> Arm
 
+// defined in x64syscall.c, track io_uring rings mmaped by the guest
+void iouring_mmap(int fd, int64_t offset, void* addr);
+void iouring_munmap(void* addr, size_t length);
+
 void UnalignSemidDs(void *dest, const void* source);
 void AlignSemidDs(void *dest, const void* source);
 
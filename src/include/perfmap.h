@@ -0,0 +1,16 @@
+#ifndef __PERFMAP_H_
+#define __PERFMAP_H_
+#include <stdint.h>
+#include <stddef.h>
+
+// BOX64_DYNAREC_PERFMAP values
+#define PERFMAP_NONE    0
+#define PERFMAP_MAP     1   // /tmp/perf-<pid>.map text file
+#define PERFMAP_JITDUMP 2   // jit-<pid>.dump binary file, for "perf inject --jit"
+
+// Register a chunk of native code generated for guest code starting at x64_addr
+void writePerfMap(uintptr_t x64_addr, void* native, size_t native_size);
+// Close the current perf map / jitdump file (will be re-opened on next write if needed)
+void closePerfMap(void);
+
+#endif //__PERFMAP_H_
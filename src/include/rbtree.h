@@ -13,6 +13,8 @@ int rb_get_end(rbtree* tree, uintptr_t addr, uint32_t* val, uintptr_t* end);
 int rb_set(rbtree *tree, uintptr_t start, uintptr_t end, uint32_t data);
 int rb_unset(rbtree *tree, uintptr_t start, uintptr_t end);
 uintptr_t rb_get_righter(rbtree *tree);
+// lowest address in [start, limit[ (start itself or aligned on mask+1) with size bytes not covered by any range, 0 if none
+uintptr_t rb_find_free(rbtree *tree, uintptr_t start, uintptr_t limit, uintptr_t size, uintptr_t mask);
 
 void print_rbtree(const rbtree *tree);
 
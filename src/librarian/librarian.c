@@ -19,6 +19,99 @@
 #include "bridge.h"
 
 KHASH_MAP_IMPL_INT(mapoffsets, cstr_t);
+static inline khint_t negkey_hash(negkey_t k)
+{
+    khint_t h = kh_str_hash_func(k.name);
+    if(k.vername)
+        h = h*31 + kh_str_hash_func(k.vername);
+    return h ^ (khint_t)((uintptr_t)k.self>>4) ^ ((khint_t)k.version<<8) ^ ((khint_t)k.veropt<<20) ^ ((khint_t)k.kind<<24);
+}
+static inline int negkey_equal(negkey_t a, negkey_t b)
+{
+    return a.kind==b.kind && a.self==b.self && a.version==b.version && a.veropt==b.veropt && !strcmp(a.name, b.name)
+        && (a.vername==b.vername || (a.vername && b.vername && !strcmp(a.vername, b.vername)));
+}
+__KHASH_IMPL(negsymbols, , negkey_t, char, 0, negkey_hash, negkey_equal);
+
+// Negative cache of global symbol lookups: a failed lookup is remembered (with all its parameters)
+// in the maplib, until the libraries of a maplib change. The maplib negcache_gen is bumped on each change,
+// so a lookup that raced with a change is not cached. Lookups only take the maplib lock for read.
+// The preloaded libs and the main elf are searched from all the maplibs: a change there bumps
+// the global negcache_epoch, and the entries of an older epoch are ignored.
+#define NEGCACHE_MAX    4096
+static uint32_t negcache_epoch = 0;
+
+static void NegCacheClear(lib_t* maplib)
+{
+    if(!maplib || !maplib->negcache)
+        return;
+    negkey_t k;
+    kh_foreach_key(maplib->negcache, k, box_free((void*)k.name));
+    kh_clear(negsymbols, maplib->negcache);
+}
+
+static void NegCacheInvalidate(lib_t* maplib)
+{
+    pthread_rwlock_wrlock(&maplib->negcache_lock);
+    ++maplib->negcache_gen;
+    NegCacheClear(maplib);
+    pthread_rwlock_unlock(&maplib->negcache_lock);
+}
+
+void NegCacheInvalidateAll(void)
+{
+    __atomic_add_fetch(&negcache_epoch, 1, __ATOMIC_ACQ_REL);
+}
+
+static negkey_t NegCacheKey(char kind, const char* name, elfheader_t* self, int version, const char* vername, int veropt)
+{
+    negkey_t key = {0};
+    key.kind = kind;
+    key.name = name;
+    key.self = self;
+    key.version = version;
+    key.vername = vername;
+    key.veropt = veropt;
+    return key;
+}
+
+static int NegCacheHas(lib_t* maplib, negkey_t key, uint64_t* gen)
+{
+    uint32_t epoch = __atomic_load_n(&negcache_epoch, __ATOMIC_ACQUIRE);
+    pthread_rwlock_rdlock(&maplib->negcache_lock);
+    *gen = ((uint64_t)epoch<<32) | maplib->negcache_gen;
+    int ret = (maplib->negcache && maplib->negcache_epoch==epoch && kh_get(negsymbols, maplib->negcache, key)!=kh_end(maplib->negcache));
+    pthread_rwlock_unlock(&maplib->negcache_lock);
+    return ret;
+}
+
+static void NegCacheAdd(lib_t* maplib, negkey_t key, uint64_t gen)
+{
+    uint32_t epoch = gen>>32;
+    pthread_rwlock_wrlock(&maplib->negcache_lock);
+    if((uint32_t)gen==maplib->negcache_gen && epoch==__atomic_load_n(&negcache_epoch, __ATOMIC_ACQUIRE)) {
+        if(!maplib->negcache)
+            maplib->negcache = kh_init(negsymbols);
+        else if(kh_size(maplib->negcache)>=NEGCACHE_MAX || maplib->negcache_epoch!=epoch)
+            NegCacheClear(maplib);
+        maplib->negcache_epoch = epoch;
+        int ret;
+        khint_t k = kh_put(negsymbols, maplib->negcache, key, &ret);
+        if(ret) {
+            // own the strings, in one block
+            size_t l = strlen(key.name)+1;
+            size_t lv = key.vername?(strlen(key.vername)+1):0;
+            char* s = (char*)box_malloc(l+lv);
+            memcpy(s, key.name, l);
+            kh_key(maplib->negcache, k).name = s;
+            if(lv) {
+                memcpy(s+l, key.vername, lv);
+                kh_key(maplib->negcache, k).vername = s+l;
+            }
+        }
+    }
+    pthread_rwlock_unlock(&maplib->negcache_lock);
+}
 
 lib_t *NewLibrarian(box64context_t* context)
 {
@@ -26,6 +119,7 @@ lib_t *NewLibrarian(box64context_t* context)
     
     maplib->mapoffsets = kh_init(mapoffsets);
     maplib->globaldata = NewMapSymbols();
+    pthread_rwlock_init(&maplib->negcache_lock, NULL);
 
     return maplib;
 }
@@ -48,6 +142,11 @@ void FreeLibrarian(lib_t **maplib, x64emu_t *emu)
     if((*maplib)->mapoffsets) {
         kh_destroy(mapoffsets, (*maplib)->mapoffsets);
     }
+    if((*maplib)->negcache) {
+        NegCacheInvalidate(*maplib);
+        kh_destroy(negsymbols, (*maplib)->negcache);
+    }
+    pthread_rwlock_destroy(&(*maplib)->negcache_lock);
     FreeMapSymbols(&(*maplib)->globaldata);
     (*maplib)->libsz = (*maplib)->libcap = 0;
 
@@ -97,6 +196,7 @@ void MapLibAddLib(lib_t* maplib, library_t* lib)
     }
     maplib->libraries[maplib->libsz] = lib;
     ++maplib->libsz;
+    NegCacheInvalidate(maplib);
 }
 
 void MapLibPrependLib(lib_t* maplib, library_t* lib, library_t* ref)
@@ -119,6 +219,7 @@ void MapLibPrependLib(lib_t* maplib, library_t* lib, library_t* ref)
         memmove(&maplib->libraries[point+1], &maplib->libraries[point], sizeof(library_t*)*(maplib->libsz-point));
     maplib->libraries[point] = lib;
     ++maplib->libsz;
+    NegCacheInvalidate(maplib);
 }
 
 static void MapLibAddMapLib(lib_t* dest, library_t* lib_src, lib_t* src)
@@ -147,6 +248,7 @@ void MapLibRemoveLib(lib_t* maplib, library_t* lib)
     if(idx!=(maplib->libsz))
         memmove(&maplib->libraries[idx], &maplib->libraries[idx+1], sizeof(library_t*)*(maplib->libsz-idx));
     maplib->libraries[maplib->libsz] = NULL;
+    NegCacheInvalidate(maplib);
 }
 
 static void MapLibRemoveMapLib(lib_t* dest, lib_t* src)
@@ -254,6 +356,7 @@ static int AddNeededLib_add(lib_t** maplib, int local, needed_libs_t* needed, in
         printf_dump(LOG_DEBUG, "Failure to Add lib => fail\n");
         return 1;
     }
+    NegCacheInvalidate(*maplib);    // symbols of the lib are now available
 
     if (lib->type == LIB_EMULATED) {
         // Need to add library to the linkmap (put here so the link is ordered)
@@ -287,6 +390,106 @@ static int AddNeededLib_add(lib_t** maplib, int local, needed_libs_t* needed, in
     return 0;
 }
 
+static int AddNeededLib_load(lib_t* maplib, int local, int bindnow, int deepbind, library_t* lib, box64context_t* box64, x64emu_t* emu)
+{
+    if(!lib)
+        return 0;
+    if(!maplib)
+        maplib = (local)?lib->maplib:my_context->maplib;
+    elfheader_t* mainelf = GetElf(lib);
+    // load dependancies of an emulated lib (nothing to do for native libs)
+    if(mainelf && LoadNeededLibs(mainelf, maplib, local, bindnow, deepbind, box64, emu)) {
+        printf_dump(LOG_DEBUG, "Failure to Add dependant lib => fail\n");
+        return 1;
+    }
+    return 0;
+}
+
+// emulated libs waiting for their init, in the same (depth first) order they would have been finalized
+typedef struct deferred_init_s {
+    library_t** libs;
+    lib_t**     local_maplibs;
+    int*        flags;      // bindnow | deepbind<<1
+    int         size;
+    int         cap;
+} deferred_init_t;
+// set while the dependencies of all the needed libs are loaded, before the libs are relocated together (lib loading is serialized)
+static deferred_init_t* deferred_init = NULL;
+
+static void AddDeferredInit(deferred_init_t* d, library_t* lib, lib_t* local_maplib, int bindnow, int deepbind)
+{
+    if(d->size==d->cap) {
+        d->cap += 16;
+        d->libs = (library_t**)box_realloc(d->libs, d->cap*sizeof(library_t*));
+        d->local_maplibs = (lib_t**)box_realloc(d->local_maplibs, d->cap*sizeof(lib_t*));
+        d->flags = (int*)box_realloc(d->flags, d->cap*sizeof(int));
+    }
+    d->libs[d->size] = lib;
+    d->local_maplibs[d->size] = local_maplib;
+    d->flags[d->size] = bindnow | (deepbind<<1);
+    ++d->size;
+}
+
+// finalize (relocate if needed, and init) the deferred libs, in order
+static int FlushDeferredInit(deferred_init_t* d, x64emu_t* emu)
+{
+    int ret = 0;
+    for (int i=0; i<d->size; ++i)
+        if(FinalizeLibrary(d->libs[i], d->local_maplibs[i], d->flags[i]&1, d->flags[i]>>1, emu)) {
+            printf_dump(LOG_DEBUG, "Failure to finalizing lib => fail\n");
+            ret = 1;
+        }
+    d->size = 0;
+    return ret;
+}
+
+typedef struct reloc_job_s {
+    deferred_init_t*    d;
+    int*        idx;    // index of the libs to relocate in d
+    int         n;
+    int         next;
+} reloc_job_t;
+
+static void* RelocateNeededLibs_thread(void* p)
+{
+    reloc_job_t* job = (reloc_job_t*)p;
+    int i;
+    while((i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED))<job->n) {
+        int j = job->idx[i];
+        RelocateLibrary(job->d->libs[j], job->d->local_maplibs[j], job->d->flags[j]&1, job->d->flags[j]>>1);
+    }
+    return NULL;
+}
+
+// Relocate the deferred emulated libs on up to box64_reloc_threads threads. Libs with relocations that
+// depend on other libs being fully relocated (COPY, IRELATIVE) are left to FinalizeLibrary.
+static void RelocateNeededLibs(deferred_init_t* d)
+{
+    int n = d->size;
+    reloc_job_t job = {0};
+    job.idx = (int*)box_calloc(n, sizeof(int));
+    job.d = d;
+    for(int i=0; i<n; ++i) {
+        library_t* lib = d->libs[i];
+        elfheader_t* h = GetElf(lib);
+        if(h && !lib->e.finalized && !lib->e.relocated && ElfRelocIsIndependent(h))
+            job.idx[job.n++] = i;
+    }
+    if(job.n>1) {
+        int nth = (box64_reloc_threads<job.n)?box64_reloc_threads:job.n;
+        pthread_t threads[nth];
+        int started = 0;
+        for(int i=1; i<nth; ++i)
+            if(!pthread_create(&threads[started], NULL, RelocateNeededLibs_thread, &job))
+                ++started;
+        printf_dump(LOG_DEBUG, "Relocating %d libs on %d threads\n", job.n, started+1);
+        RelocateNeededLibs_thread(&job);
+        for(int i=0; i<started; ++i)
+            pthread_join(threads[i], NULL);
+    }
+    box_free(job.idx);
+}
+
 int AddNeededLib_init(lib_t* maplib, int local, int bindnow, int deepbind, library_t* lib, elfheader_t* verneeded, box64context_t* box64, x64emu_t* emu)
 {
     if(!lib)    // no lib, error is already detected, no need to return a new one
@@ -301,11 +504,14 @@ int AddNeededLib_init(lib_t* maplib, int local, int bindnow, int deepbind, libra
     } else {
         // it's an emulated lib, 
         // load dependancies and launch init sequence
-        if(LoadNeededLibs(mainelf, maplib, local, bindnow, deepbind, box64, emu)) {
-            printf_dump(LOG_DEBUG, "Failure to Add dependant lib => fail\n");
+        if(AddNeededLib_load(maplib, local, bindnow, deepbind, lib, box64, emu))
             return 1;
-        }
 
+        if(deferred_init) {
+            // relocation and init will be done later, in that same order
+            AddDeferredInit(deferred_init, lib, local?maplib:NULL, bindnow, deepbind);
+            return 0;
+        }
         // finalize the lib
         if(FinalizeLibrary(lib, local?maplib:NULL, bindnow, deepbind, emu)) {
             printf_dump(LOG_DEBUG, "Failure to finalizing lib => fail\n");
@@ -349,6 +555,25 @@ int AddNeededLib(lib_t* maplib, int local, int bindnow, int deepbind, needed_lib
     
     // add dependant libs and init them
     int n = needed->size;
+    if(box64_reloc_threads>1 && n>1 && !deferred_init) {
+        // load all the dependancies first, without init, so the libs can be relocated together
+        // the init sequence is then done serially, in the same depth first order as without BOX64_RELOC_THREADS
+        deferred_init_t d = {0};
+        deferred_init = &d;
+        for (int i=0; i<n; ++i)
+            if(AddNeededLib_init(maplib, local, bindnow, deepbind, needed->libs[n-i-1], verneeded, box64, emu)) {
+                printf_log(LOG_INFO, "Error initializing needed lib %s\n", needed->names[n-i-1]);
+                ret = 1;
+            }
+        deferred_init = NULL;
+        if(!ret)
+            RelocateNeededLibs(&d);
+        if(FlushDeferredInit(&d, emu))
+            ret = 1;
+        box_free(d.libs);
+        box_free(d.local_maplibs);
+        box_free(d.flags);
+    } else
     for (int i=0; i<n; ++i)
         if(AddNeededLib_init(maplib, local, bindnow, deepbind, needed->libs[n-i-1], verneeded, box64, emu)) {
             printf_log(LOG_INFO, "Error initializing needed lib %s\n", needed->names[i]);
@@ -356,6 +581,9 @@ int AddNeededLib(lib_t* maplib, int local, int bindnow, int deepbind, needed_lib
         }
     // error while loadind lib, unload...
     if(ret) {
+        // the libs already loaded would have been initialized by now, do it before they get unloaded
+        if(deferred_init)
+            FlushDeferredInit(deferred_init, emu);
         int n = needed->size;
         for (int i=0; i<n; ++i)
             DecRefCount(&needed->libs[n-i-1], emu);
@@ -420,9 +648,8 @@ static void CheckNeededLibs(needed_libs_t* needed)
     }
 }
 
-int GetNoSelfSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, size_t size, int version, const char* vername, int veropt, void** elfsym)
+static int GetNoSelfSymbolStartEnd_internal(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, size_t size, int version, const char* vername, int veropt, void** elfsym)
 {
-    assert(self);   // need self for this one
     int weak = 0;
     void* sym;
     // search in needed libs from preloaded first, in order
@@ -462,7 +689,23 @@ int GetNoSelfSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, u
     // nope, not found
     return weak;
 }
-static int GetGlobalSymbolStartEnd_internal(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int* version, const char** vername, int* veropt, void** elfsym)
+int GetNoSelfSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, size_t size, int version, const char* vername, int veropt, void** elfsym)
+{
+    assert(self);   // need self for this one
+    uint64_t gen;
+    int cache = (maplib!=NULL);
+    negkey_t key = NegCacheKey('n', name, self, version, vername, veropt);
+    if(cache && NegCacheHas(maplib, key, &gen))
+        return 0;
+    elfsymhash_t hash;
+    PushSymbolHash(&hash, name);
+    int ret = GetNoSelfSymbolStartEnd_internal(maplib, name, start, end, self, size, version, vername, veropt, elfsym);
+    PopSymbolHash(&hash);
+    if(!ret && cache)
+        NegCacheAdd(maplib, key, gen);
+    return ret;
+}
+static int GetGlobalSymbolStartEnd_search(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int* version, const char** vername, int* veropt, void** elfsym)
 {
     int weak = 0;
     size_t size = 0;
@@ -502,6 +745,21 @@ static int GetGlobalSymbolStartEnd_internal(lib_t *maplib, const char* name, uin
     // nope, not found
     return weak;
 }
+static int GetGlobalSymbolStartEnd_internal(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int* version, const char** vername, int* veropt, void** elfsym)
+{
+    uint64_t gen;
+    int cache = (maplib!=NULL);
+    negkey_t key = NegCacheKey('g', name, self, *version, *vername, *veropt);
+    if(cache && NegCacheHas(maplib, key, &gen))
+        return 0;
+    elfsymhash_t hash;
+    PushSymbolHash(&hash, name);
+    int ret = GetGlobalSymbolStartEnd_search(maplib, name, start, end, self, version, vername, veropt, elfsym);
+    PopSymbolHash(&hash);
+    if(!ret && cache)
+        NegCacheAdd(maplib, key, gen);
+    return ret;
+}
 #ifndef STATICBUILD
 void** my_GetGTKDisplay();
 void** my_GetGthreadsGotInitialized();
@@ -541,7 +799,7 @@ int GetGlobalSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, u
     return 0;
 }
 
-static int GetGlobalWeakSymbolStartEnd_internal(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int* version, const char** vername, int* veropt, void** elfsym)
+static int GetGlobalWeakSymbolStartEnd_search(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int* version, const char** vername, int* veropt, void** elfsym)
 {
     int weak = 0;
     size_t size = 0;
@@ -578,6 +836,21 @@ static int GetGlobalWeakSymbolStartEnd_internal(lib_t *maplib, const char* name,
     // nope, not found
     return ok;
 }
+static int GetGlobalWeakSymbolStartEnd_internal(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int* version, const char** vername, int* veropt, void** elfsym)
+{
+    uint64_t gen;
+    int cache = (maplib!=NULL);
+    negkey_t key = NegCacheKey('w', name, self, *version, *vername, *veropt);
+    if(cache && NegCacheHas(maplib, key, &gen))
+        return 0;
+    elfsymhash_t hash;
+    PushSymbolHash(&hash, name);
+    int ret = GetGlobalWeakSymbolStartEnd_search(maplib, name, start, end, self, version, vername, veropt, elfsym);
+    PopSymbolHash(&hash);
+    if(!ret && cache)
+        NegCacheAdd(maplib, key, gen);
+    return ret;
+}
 
 int GetGlobalWeakSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int version, const char* vername, int veropt, void** elfsym)
 {
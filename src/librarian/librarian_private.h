@@ -1,6 +1,7 @@
 #ifndef __LIBRARIAN_PRIVATE_H_
 #define __LIBRARIAN_PRIVATE_H_
 #include <stdint.h>
+#include <pthread.h>
 
 #include "custommem.h"
 #include "khash.h"
@@ -11,6 +12,16 @@ typedef struct kh_mapsymbols_s kh_mapsymbols_t;
 typedef char* cstr_t;
 
 KHASH_MAP_DECLARE_INT(mapoffsets, cstr_t);
+// key of a failed global symbol lookup
+typedef struct negkey_s {
+    const char*     name;
+    const char*     vername;
+    void*           self;
+    int             version;
+    int             veropt;
+    char            kind;
+} negkey_t;
+KHASH_DECLARE(negsymbols, negkey_t, char);
 
 typedef struct lib_s {
     khash_t(mapoffsets)   *mapoffsets;
@@ -19,6 +30,10 @@ typedef struct lib_s {
     int                   libsz;
     int                   libcap;
     library_t             *owner;       // in case that maplib is owned by a lib
+    khash_t(negsymbols)   *negcache;    // global symbol lookups that failed
+    pthread_rwlock_t      negcache_lock;
+    uint32_t              negcache_gen; // bumped each time the libraries of the maplib change
+    uint32_t              negcache_epoch;   // negcache_epoch (global) of the cached entries
 } lib_t;
 
 #endif //__LIBRARIAN_PRIVATE_H_
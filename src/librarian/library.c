@@ -11,6 +11,7 @@
 #include <errno.h>
 #include <link.h>
 #include <stdarg.h>
+#include <pthread.h>
 
 #include "debug.h"
 #include "library.h"
@@ -546,6 +547,24 @@ int AddSymbolsLibrary(lib_t *maplib, library_t* lib, x64emu_t* emu)
     }
     return 0;
 }
+int RelocateLibrary(library_t* lib, lib_t* local_maplib, int bindnow, int deepbind)
+{
+    if(!lib || lib->type!=LIB_EMULATED)
+        return 0;
+    if(!lib->e.relocated) {
+        elfheader_t *elf_header = my_context->elfs[lib->e.elf_index];
+        lib->e.relocated = 1;
+        if(RelocateElf(my_context->maplib, local_maplib, bindnow, deepbind, elf_header)) {
+            printf_log(LOG_NONE, "Error: relocating symbols in elf %s\n", lib->name);
+            lib->e.relocated = -1;
+        } else if(RelocateElfPlt(my_context->maplib, local_maplib, bindnow, deepbind, elf_header)) {
+            printf_log(LOG_NONE, "Error: relocating Plt symbols in elf %s\n", lib->name);
+            lib->e.relocated = -1;
+        }
+    }
+    return (lib->e.relocated<0)?1:0;
+}
+
 int FinalizeLibrary(library_t* lib, lib_t* local_maplib, int bindnow, int deepbind, x64emu_t* emu)
 {
     if(!lib)
@@ -556,15 +575,9 @@ int FinalizeLibrary(library_t* lib, lib_t* local_maplib, int bindnow, int deepbi
             return 0;
         lib->e.finalized = 1;
         elfheader_t *elf_header = my_context->elfs[lib->e.elf_index];
-        // finalize relocations
-        if(RelocateElf(my_context->maplib, local_maplib, bindnow, deepbind, elf_header)) {
-            printf_log(LOG_NONE, "Error: relocating symbols in elf %s\n", lib->name);
-            return 1;
-        }
-        if(RelocateElfPlt(my_context->maplib, local_maplib, bindnow, deepbind, elf_header)) {
-            printf_log(LOG_NONE, "Error: relocating Plt symbols in elf %s\n", lib->name);
+        // finalize relocations (if not already done along with the other needed libs)
+        if(RelocateLibrary(lib, local_maplib, bindnow, deepbind))
             return 1;
-        }
 #ifdef HAVE_TRACE
         if(trace_func) {
             int weak;
@@ -838,6 +851,18 @@ static int getSymbolInDataMaps(library_t*lib, const char* name, int noweak, uint
     }
     return 0;
 }
+// several threads can resolve the same symbol (BOX64_RELOC_THREADS, lazy binding...), only one bridge must be published
+static pthread_mutex_t mutex_resolve = PTHREAD_MUTEX_INITIALIZER;
+static void resolveBridge(library_t* lib, int* resolved, uintptr_t* addr, wrapper_t w, void* symbol, int N, const char* name)
+{
+    pthread_mutex_lock(&mutex_resolve);
+    if(!*resolved) {
+        *addr = AddBridge(lib->w.bridge, w, symbol, N, name);
+        __atomic_store_n(resolved, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&mutex_resolve);
+}
+
 static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, uintptr_t *addr, uintptr_t *size, int* weak)
 {
     const khint_t hash = kh_hash(symbolmap, name);
@@ -846,7 +871,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
     khint_t k = kh_get_with_hash(symbolmap, lib->w.mysymbolmap, name, hash);
     if (k!=kh_end(lib->w.mysymbolmap)) {
         symbol1_t *s = &kh_value(lib->w.mysymbolmap, k);
-        if(!s->resolved) {
+        if(!__atomic_load_n(&s->resolved, __ATOMIC_ACQUIRE)) {
             char buff[200];
             if(lib->w.altmy)
                 strcpy(buff, lib->w.altmy);
@@ -862,8 +887,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
                 printf_log(LOG_NONE, "Warning, function %s not found\n", buff);
                 return 0;
             }
-            s->addr = AddBridge(lib->w.bridge, s->w, symbol, 0, name);
-            s->resolved = 1;
+            resolveBridge(lib, &s->resolved, &s->addr, s->w, symbol, 0, name);
         }
         *addr = s->addr;
         *size = sizeof(void*);
@@ -874,7 +898,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
     k = kh_get_with_hash(symbolmap, lib->w.stsymbolmap, name, hash);
     if (k!=kh_end(lib->w.stsymbolmap)) {
         symbol1_t *s = &kh_value(lib->w.stsymbolmap, k);
-        if(!s->resolved) {
+        if(!__atomic_load_n(&s->resolved, __ATOMIC_ACQUIRE)) {
             char buff[200];
             if(lib->w.altmy)
                 strcpy(buff, lib->w.altmy);
@@ -890,8 +914,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
                 printf_log(LOG_NONE, "Warning, function %s not found\n", buff);
                 return 0;
             }
-            s->addr = AddBridge(lib->w.bridge, s->w, symbol, sizeof(void*), name);
-            s->resolved = 1;
+            resolveBridge(lib, &s->resolved, &s->addr, s->w, symbol, sizeof(void*), name);
         }
         *addr = s->addr;
         *size = sizeof(void*);
@@ -902,7 +925,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
     k = kh_get_with_hash(symbolmap, lib->w.symbolmap, name, hash);
     if (k!=kh_end(lib->w.symbolmap)) {
         symbol1_t *s = &kh_value(lib->w.symbolmap, k);
-        if(!s->resolved) {
+        if(!__atomic_load_n(&s->resolved, __ATOMIC_ACQUIRE)) {
             #ifdef STATICBUILD
             symbol = (void*)s->addr;
             #else
@@ -926,8 +949,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
                 printf_dump(LOG_INFO, "Warning, function %s not found in lib %s\n", name, lib->name);
                 return 0;
             }
-            s->addr = AddBridge(lib->w.bridge, s->w, symbol, 0, name);
-            s->resolved = 1;
+            resolveBridge(lib, &s->resolved, &s->addr, s->w, symbol, 0, name);
         }
         *addr = s->addr;
         *size = sizeof(void*);
@@ -939,7 +961,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
         khint_t k = kh_get_with_hash(symbolmap, lib->w.wmysymbolmap, name, hash);
         if (k!=kh_end(lib->w.wmysymbolmap)) {
             symbol1_t *s = &kh_value(lib->w.wmysymbolmap, k);
-            if(!s->resolved) {
+            if(!__atomic_load_n(&s->resolved, __ATOMIC_ACQUIRE)) {
                 char buff[200];
                 if(lib->w.altmy)
                     strcpy(buff, lib->w.altmy);
@@ -955,8 +977,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
                     printf_log(LOG_NONE, "Warning, function %s not found\n", buff);
                     return 0;
                 }
-                s->addr = AddBridge(lib->w.bridge, s->w, symbol, 0, name);
-                s->resolved = 1;
+                resolveBridge(lib, &s->resolved, &s->addr, s->w, symbol, 0, name);
             }
             *addr = s->addr;
             *size = sizeof(void*);
@@ -966,7 +987,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
         k = kh_get_with_hash(symbolmap, lib->w.wsymbolmap, name, hash);
         if (k!=kh_end(lib->w.wsymbolmap)) {
             symbol1_t *s = &kh_value(lib->w.wsymbolmap, k);
-            if(!s->resolved) {
+            if(!__atomic_load_n(&s->resolved, __ATOMIC_ACQUIRE)) {
                 #ifdef STATICBUILD
                 symbol = (void*)s->addr;
                 #else
@@ -990,8 +1011,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
                     printf_dump(LOG_INFO, "Warning, function %s not found in lib %s\n", name, lib->name);
                     return 0;
                 }
-                s->addr = AddBridge(lib->w.bridge, s->w, symbol, 0, name);
-                s->resolved = 1;
+                resolveBridge(lib, &s->resolved, &s->addr, s->w, symbol, 0, name);
             }
             *addr = s->addr;
             *size = sizeof(void*);
@@ -1007,7 +1027,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
         symbol2_t *s = &kh_value(lib->w.symbol2map, k);
         if(!noweak || !s->weak)
         {
-            if(!s->resolved) {
+            if(!__atomic_load_n(&s->resolved, __ATOMIC_ACQUIRE)) {
                 #ifdef STATICBUILD
                 symbol = (void*)s->addr;
                 #else
@@ -1021,8 +1041,7 @@ static int getSymbolInSymbolMaps(library_t*lib, const char* name, int noweak, ui
                     printf_dump(LOG_INFO, "Warning, function %s not found in lib %s\n", kh_value(lib->w.symbol2map, k).name, lib->name);
                     return 0;
                 }
-                s->addr = AddBridge(lib->w.bridge, s->w, symbol, 0, name);
-                s->resolved = 1;
+                resolveBridge(lib, &s->resolved, &s->addr, s->w, symbol, 0, name);
             }
             *addr = s->addr;
             *size = sizeof(void*);
@@ -73,6 +73,7 @@ typedef struct elib_s {
     int             elf_index;
     elfheader_t     *elf;
     int             finalized;
+    int             relocated;  // 1: done, -1: failed
 } elib_t;
 
 typedef struct library_s {
@@ -561,6 +561,23 @@ void UnalignEpollEvent(void* dest, void* source, int nbr)
 {
     struct x64_epoll_event *x64_struct = (struct x64_epoll_event*)dest;
     struct epoll_event *arm_struct = (struct epoll_event*)source;
+    // 4 events (64 bytes in, 48 bytes out) at a time, with 64bits loads/stores the compiler can pair or vectorize
+    // (x64 buffer may not be 8 bytes aligned, hence the memcpy)
+    while(nbr>=4) {
+        uint64_t s[8], d[6];
+        memcpy(s, arm_struct, sizeof(s));
+        // little endian: events | data<<32, data>>32 | next events<<32, next data...
+        d[0] = (uint32_t)s[0] | (s[1]<<32);
+        d[1] = (s[1]>>32) | (s[2]<<32);
+        d[2] = s[3];
+        d[3] = (uint32_t)s[4] | (s[5]<<32);
+        d[4] = (s[5]>>32) | (s[6]<<32);
+        d[5] = s[7];
+        memcpy(x64_struct, d, sizeof(d));
+        x64_struct += 4;
+        arm_struct += 4;
+        nbr -= 4;
+    }
     while(nbr) {
         x64_struct->events = arm_struct->events;
         x64_struct->data = arm_struct->data.u64;
@@ -468,13 +468,16 @@ EXPORT int my_sigaltstack(x64emu_t* emu, const x64_stack_t* ss, x64_stack_t* oss
 
 
 #ifdef DYNAREC
-uintptr_t getX64Address(dynablock_t* db, uintptr_t arm_addr)
+// find the x64 instruction that contains arm_addr, also gives its native start and x64 size
+static uintptr_t getX64Inst(dynablock_t* db, uintptr_t arm_addr, uintptr_t* armstart, int* x64size)
 {
     uintptr_t x64addr = (uintptr_t)db->x64_addr;
     uintptr_t armaddr = (uintptr_t)db->block;
     int i = 0;
+    int x64sz = 0;
+    int found = 0;
     do {
-        int x64sz = 0;
+        x64sz = 0;
         int armsz = 0;
         do {
             x64sz+=db->instsize[i].x64;
@@ -482,17 +485,43 @@ uintptr_t getX64Address(dynablock_t* db, uintptr_t arm_addr)
             ++i;
         } while((db->instsize[i-1].x64==15) || (db->instsize[i-1].nat==15));
         // if the opcode is a NOP on ARM side (so armsz==0), it cannot be an address to find
-        if((arm_addr>=armaddr) && (arm_addr<(armaddr+armsz)))
-            return x64addr;
+        if((arm_addr>=armaddr) && (arm_addr<(armaddr+armsz))) {
+            found = 1;
+            break;
+        }
         armaddr+=armsz;
         x64addr+=x64sz;
     } while(db->instsize[i].x64 || db->instsize[i].nat);
+    if(armstart) *armstart = armaddr;
+    if(x64size) *x64size = found?x64sz:0;
     return x64addr;
 }
+uintptr_t getX64Address(dynablock_t* db, uintptr_t arm_addr)
+{
+    return getX64Inst(db, arm_addr, NULL, NULL);
+}
+#ifdef ARM64
+// An inlined SYSCALL (see dynarec_arm64_0f.c) uses x0 for the 1st arg and the return value around the SVC,
+// after having saved emu in x7 with a "MOV x7, xEmu" as part of the native code of that SYSCALL
+static int isInlineSyscallEmuX7(dynablock_t* db, uintptr_t pc)
+{
+    uintptr_t armstart;
+    int x64sz;
+    uintptr_t x64addr = getX64Inst(db, pc, &armstart, &x64sz);
+    if(x64sz<2 || pc<armstart || ((uint8_t*)x64addr)[x64sz-2]!=0x0F || ((uint8_t*)x64addr)[x64sz-1]!=0x05)
+        return 0;
+    for(uint32_t* op=(uint32_t*)armstart; (uintptr_t)op<pc; ++op)
+        if(*op==0xAA0003E7)    // MOV x7, xEmu
+            return 1;
+    return 0;
+}
+#endif
 x64emu_t* getEmuSignal(x64emu_t* emu, ucontext_t* p, dynablock_t* db)
 {
 #if defined(ARM64)
-        if(db && p->uc_mcontext.regs[0]>0x10000) {
+        if(db && isInlineSyscallEmuX7(db, p->uc_mcontext.pc)) {
+            emu = (x64emu_t*)p->uc_mcontext.regs[7];
+        } else if(db && p->uc_mcontext.regs[0]>0x10000) {
             emu = (x64emu_t*)p->uc_mcontext.regs[0];
         }
 #elif defined(LA64)
@@ -811,6 +840,48 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd)
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
+    if(((opcode&0b00111111111111111111110000000000)==0b00111000101111111100000000000000)
+     || ((opcode&0b00111111111000000000110000000000)==0b00011001010000000000000000000000)) {
+        // this is LDAPR or LDAPUR (strongmem MOV), that SIGBUS on unaligned address without LSE2 or when crossing 16 bytes
+        int size = 1<<((opcode>>30)&3);
+        int val = opcode&31;
+        int dest = (opcode>>5)&31;
+        int64_t offset = 0;
+        if((opcode>>24)&1) {   // LDAPUR/STLUR have a signed 9bits offset
+            offset = (opcode>>12)&0b111111111;
+            if((offset>>(9-1))&1)
+                offset |= (0xffffffffffffffffll<<9);
+        }
+        volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest] + offset);
+        uint64_t value = 0;
+        for(int i=0; i<size; ++i)
+            value |= ((uint64_t)addr[i]) << (i*8);
+        __sync_synchronize();   // acquire
+        if(val!=31)
+            p->uc_mcontext.regs[val] = value;
+        p->uc_mcontext.pc+=4;   // go to next opcode
+        return 1;
+    }
+    if(((opcode&0b00111111111111111111110000000000)==0b00001000100111111111110000000000)
+     || ((opcode&0b00111111111000000000110000000000)==0b00011001000000000000000000000000)) {
+        // this is STLR or STLUR (strongmem MOV), that SIGBUS on unaligned address without LSE2 or when crossing 16 bytes
+        int size = 1<<((opcode>>30)&3);
+        int val = opcode&31;
+        int dest = (opcode>>5)&31;
+        int64_t offset = 0;
+        if((opcode>>24)&1) {   // LDAPUR/STLUR have a signed 9bits offset
+            offset = (opcode>>12)&0b111111111;
+            if((offset>>(9-1))&1)
+                offset |= (0xffffffffffffffffll<<9);
+        }
+        volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest] + offset);
+        uint64_t value = (val==31)?0:p->uc_mcontext.regs[val];
+        __sync_synchronize();   // release
+        for(int i=0; i<size; ++i)
+            addr[i] = (value>>(i*8))&0xff;
+        p->uc_mcontext.pc+=4;   // go to next opcode
+        return 1;
+    }
     if((opcode&0b11111111110000000000000000000000)==0b01111001000000000000000000000000) {
         // this is STRH
         int scale = (opcode>>30)&3;
@@ -979,6 +1050,9 @@ void my_sigactionhandler_oldcode(int32_t sig, int simple, siginfo_t* info, void
 #endif
     // setup libc context stack frame, on caller stack
     frame = frame&~15;
+    // handlers without SA_SIGINFO cannot look at the ucontext, so for asynchronous signals (timers, SIGCHLD, profilers...)
+    // only the general registers are filled (needed to resume), the FPU/SSE state is not saved and no trap info is computed
+    int fast = simple && sig!=SIGSEGV && sig!=SIGBUS && sig!=SIGILL && sig!=SIGFPE && sig!=SIGTRAP;
 
     // stack tracking
     x64_stack_t *new_ss = my_context->onstack[sig]?(x64_stack_t*)pthread_getspecific(sigstack_key):NULL;
@@ -1107,11 +1181,15 @@ void my_sigactionhandler_oldcode(int32_t sig, int simple, siginfo_t* info, void
         #undef GO
     }
     // get FloatPoint status
-    sigcontext->uc_mcontext.fpregs = xstate;//(struct x64_libc_fpstate*)&sigcontext->xstate;
-    fpu_xsave_mask(emu, xstate, 0, 0b111);
-    memcpy(&sigcontext->xstate, xstate, sizeof(sigcontext->xstate));
-    ((struct x64_fpstate*)xstate)->res[12] = 0x46505853;   // magic number to signal an XSTATE type of fpregs
-    ((struct x64_fpstate*)xstate)->res[13] = 0; // offset to xstate after this?
+    if(fast)
+        sigcontext->uc_mcontext.fpregs = NULL;
+    else {
+        sigcontext->uc_mcontext.fpregs = xstate;//(struct x64_libc_fpstate*)&sigcontext->xstate;
+        fpu_xsave_mask(emu, xstate, 0, 0b111);
+        memcpy(&sigcontext->xstate, xstate, sizeof(sigcontext->xstate));
+        ((struct x64_fpstate*)xstate)->res[12] = 0x46505853;   // magic number to signal an XSTATE type of fpregs
+        ((struct x64_fpstate*)xstate)->res[13] = 0; // offset to xstate after this?
+    }
     // get signal mask
 
     if(new_ss) {
@@ -1142,10 +1220,10 @@ void my_sigactionhandler_oldcode(int32_t sig, int simple, siginfo_t* info, void
     TRAP_x86_MCHK       = 18,  // Machine check exception
     TRAP_x86_CACHEFLT   = 19   // SIMD exception (via SIGFPE) if CPU is SSE capable otherwise Cache flush exception (via SIGSEV)
     */
-    uint32_t prot = getProtection((uintptr_t)info->si_addr);
     if(sig==SIGBUS)
         sigcontext->uc_mcontext.gregs[X64_TRAPNO] = 17;
     else if(sig==SIGSEGV) {
+        uint32_t prot = getProtection((uintptr_t)info->si_addr);
         if((uintptr_t)info->si_addr == sigcontext->uc_mcontext.gregs[X64_RIP]) {
             sigcontext->uc_mcontext.gregs[X64_ERR] = (info->si_errno==0x1234)?0:((info->si_errno==0xdead)?(0x2|(info->si_code<<3)):0x0010);    // execution flag issue (probably), unless it's a #GP(0)
             sigcontext->uc_mcontext.gregs[X64_TRAPNO] = ((info->si_code==SEGV_ACCERR) || (info->si_errno==0x1234) || (info->si_errno==0xdead) || ((uintptr_t)info->si_addr==0))?13:14;
@@ -1203,7 +1281,11 @@ void my_sigactionhandler_oldcode(int32_t sig, int simple, siginfo_t* info, void
     //TODO: SIGABRT generate what?
     printf_log(LOG_DEBUG, "Signal %d: si_addr=%p, TRAPNO=%d, ERR=%d, RIP=%p\n", sig, (void*)info2->si_addr, sigcontext->uc_mcontext.gregs[X64_TRAPNO], sigcontext->uc_mcontext.gregs[X64_ERR],sigcontext->uc_mcontext.gregs[X64_RIP]);
     // call the signal handler
-    x64_ucontext_t sigcontext_copy = *sigcontext;
+    x64_ucontext_t sigcontext_copy;
+    if(fast)
+        memcpy(sigcontext_copy.uc_mcontext.gregs, sigcontext->uc_mcontext.gregs, sizeof(sigcontext_copy.uc_mcontext.gregs));
+    else
+        sigcontext_copy = *sigcontext;
     // save old value from emu
     #define GO(A) uint64_t old_##A = R_##A
     GO(RAX);
@@ -1242,7 +1324,7 @@ void my_sigactionhandler_oldcode(int32_t sig, int simple, siginfo_t* info, void
     GO(RBP);
     #undef GO
 
-    if(memcmp(sigcontext, &sigcontext_copy, sizeof(x64_ucontext_t))) {
+    if(fast?memcmp(sigcontext->uc_mcontext.gregs, sigcontext_copy.uc_mcontext.gregs, sizeof(sigcontext_copy.uc_mcontext.gregs)):memcmp(sigcontext, &sigcontext_copy, sizeof(x64_ucontext_t))) {
         if(emu->jmpbuf) {
             #define GO(R)   emu->regs[_##R].q[0]=sigcontext->uc_mcontext.gregs[X64_R##R]
             GO(AX);
@@ -1896,7 +1978,7 @@ void my_sigactionhandler(int32_t sig, siginfo_t* info, void * ucntx)
     void* db = NULL;
     #endif
 
-    my_sigactionhandler_oldcode(sig, 0, info, ucntx, NULL, db);
+    my_sigactionhandler_oldcode(sig, my_context->is_sigaction[sig]?0:1, info, ucntx, NULL, db);
 }
 
 #ifndef DYNAREC
@@ -129,6 +129,81 @@ void my_longjmp(x64emu_t* emu, /*struct __jmp_buf_tag __env[1]*/void *p, int32_t
 
 static pthread_key_t thread_key;
 
+// Pool of emus (with their own stack) from exited threads, reused for new threads and native threads calling guest code
+#define EMUPOOL_SIZE	16
+typedef struct emupool_s {
+	x64emu_t*	emu;
+	void*		stack;
+	int			stacksize;
+} emupool_t;
+static emupool_t emupool[EMUPOOL_SIZE];
+static int emupool_n = 0;
+
+// get an emu with a stack of stacksize from the pool, or create a new one
+static x64emu_t* NewThreadEmu(uintptr_t start, int stacksize)
+{
+	x64emu_t* emu = NULL;
+	void* stack = NULL;
+	if(emupool_n) {
+		mutex_lock(&my_context->mutex_thread);
+		for(int i=emupool_n-1; i>=0 && !emu; --i)
+			if(emupool[i].stacksize==stacksize) {
+				emu = emupool[i].emu;
+				stack = emupool[i].stack;
+				emupool[i] = emupool[--emupool_n];
+			}
+		mutex_unlock(&my_context->mutex_thread);
+	}
+	if(emu) {
+		memset(emu, 0, sizeof(x64emu_t));
+		return NewX64EmuFromStack(emu, my_context, start, (uintptr_t)stack, stacksize, 1);
+	}
+	stack = internal_mmap(NULL, stacksize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_GROWSDOWN, -1, 0);
+	if(stack!=MAP_FAILED)
+		setProtection((uintptr_t)stack, stacksize, PROT_READ|PROT_WRITE);
+	return NewX64Emu(my_context, start, (uintptr_t)stack, stacksize, 1);
+}
+
+// a stack can only be reused if the guest didn't change its protection (guard page, mprotect...) and no code was compiled from it
+static int isStackReusable(void* stack, int stacksize)
+{
+	for(uintptr_t p=(uintptr_t)stack; p<(uintptr_t)stack+stacksize; p+=box64_pagesize)
+		if(getProtection(p)!=(PROT_READ|PROT_WRITE))
+			return 0;
+	return 1;
+}
+
+// put back the emu and its stack in the pool if possible, else free them
+static void FreeThreadEmu(x64emu_t** emu)
+{
+	x64emu_t* e = *emu;
+	if(e && !box64_is32bits && my_context && e->stack2free && e->stack2free!=MAP_FAILED && isStackReusable(e->stack2free, e->size_stack)) {
+		if(e->test.emu)
+			FreeX64Emu(&e->test.emu);
+		mutex_lock(&my_context->mutex_thread);
+		if(emupool_n<EMUPOOL_SIZE) {
+			emupool[emupool_n].emu = e;
+			emupool[emupool_n].stack = e->stack2free;
+			emupool[emupool_n].stacksize = e->size_stack;
+			++emupool_n;
+			e = NULL;
+		}
+		mutex_unlock(&my_context->mutex_thread);
+		if(!e) {
+			*emu = NULL;
+			return;
+		}
+	}
+	FreeX64Emu(emu);
+}
+
+static void CleanThreadEmuPool(void)
+{
+	for(int i=0; i<emupool_n; ++i)
+		FreeX64Emu(&emupool[i].emu);
+	emupool_n = 0;
+}
+
 static void emuthread_destroy(void* p)
 {
 	emuthread_t *et = (emuthread_t*)p;
@@ -138,7 +213,7 @@ static void emuthread_destroy(void* p)
 	if(!et->join && et->fnc)
 		to_hash_d(et->self);
 	#endif
-	FreeX64Emu(&et->emu);
+	FreeThreadEmu(&et->emu);
 	box_free(et);
 }
 
@@ -202,10 +277,7 @@ x64emu_t* thread_get_emu()
 					stacksize = stack_size;
 			pthread_attr_destroy(&attr);
 		}
-		void* stack = internal_mmap(NULL, stacksize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_GROWSDOWN, -1, 0);
-		if(stack!=MAP_FAILED)
-			setProtection((uintptr_t)stack, stacksize, PROT_READ|PROT_WRITE);
-		x64emu_t *emu = NewX64Emu(my_context, 0, (uintptr_t)stack, stacksize, 1);
+		x64emu_t *emu = NewThreadEmu(0, stacksize);
 		SetupX64Emu(emu, NULL);
 		thread_set_emu(emu);
 		return emu;
@@ -493,7 +565,7 @@ EXPORT int my_pthread_create(x64emu_t *emu, void* t, void* attr, void* start_rou
 	void* attr_stack;
 	size_t attr_stacksize;
 	int own;
-	void* stack;
+	void* stack = NULL;
 
 	if(attr) {
 		size_t stsize;
@@ -507,14 +579,11 @@ EXPORT int my_pthread_create(x64emu_t *emu, void* t, void* attr, void* start_rou
 		stacksize = attr_stacksize;
 		own = 0;
 	} else {
-		stack = internal_mmap(NULL, stacksize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_GROWSDOWN, -1, 0);
-		if(stack!=MAP_FAILED)
-	        setProtection((uintptr_t)stack, stacksize, PROT_READ|PROT_WRITE);
 		own = 1;
 	}
 
 	emuthread_t *et = (emuthread_t*)box_calloc(1, sizeof(emuthread_t));
-    x64emu_t *emuthread = NewX64Emu(my_context, (uintptr_t)start_routine, (uintptr_t)stack, stacksize, own);
+	x64emu_t *emuthread = own?NewThreadEmu((uintptr_t)start_routine, stacksize):NewX64Emu(my_context, (uintptr_t)start_routine, (uintptr_t)stack, stacksize, own);
 	SetupX64Emu(emuthread, emu);
 	//SetFS(emuthread, GetFS(emu));
 	et->emu = emuthread;
@@ -536,11 +605,8 @@ EXPORT int my_pthread_create(x64emu_t *emu, void* t, void* attr, void* start_rou
 void* my_prepare_thread(x64emu_t *emu, void* f, void* arg, int ssize, void** pet)
 {
 	int stacksize = (ssize)?ssize:(2*1024*1024);	//default stack size is 2Mo
-	void* stack = internal_mmap(NULL, stacksize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_GROWSDOWN, -1, 0);
-	if(stack!=MAP_FAILED)
-		setProtection((uintptr_t)stack, stacksize, PROT_READ|PROT_WRITE);
 	emuthread_t *et = (emuthread_t*)box_calloc(1, sizeof(emuthread_t));
-	x64emu_t *emuthread = NewX64Emu(emu->context, (uintptr_t)f, (uintptr_t)stack, stacksize, 1);
+	x64emu_t *emuthread = NewThreadEmu((uintptr_t)f, stacksize);
 	SetupX64Emu(emuthread, emu					);
 	//SetFS(emuthread, GetFS(emu));
 	et->emu = emuthread;
@@ -1217,6 +1283,7 @@ void fini_pthread_helper(box64context_t* context)
 	#endif
 	CleanStackSize(context);
 	clean_current_emuthread();
+	CleanThreadEmuPool();
 }
 
 int checkUnlockMutex(void* m)
@@ -0,0 +1,104 @@
+#define _GNU_SOURCE         /* See feature_test_macros(7) */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "box64context.h"
+#include "debug.h"
+#include "librarian.h"
+#include "elfs/elfloader_private.h"
+#include "custommem.h"
+#include "bridge.h"
+#include "wrapper.h"
+
+/*
+    This file redirects the x86_64 glibc string/memory variants found in emulated elfs to the native libc.
+
+ When libc is wrapped, memcpy, strlen and friends already are native functions. But statically linked programs
+ and emulated copies of libc carry their own x86_64 versions, hand written with SSE2/AVX2/EVEX. Those are the
+ actual entry points selected by the IFUNC resolvers of memcpy, strlen, etc. and are among the hottest functions
+ of many programs. Running them through the dynarec means translating a vector loop per call, where the native
+ libc has an optimized version for the host.
+
+ The variants are recognized by name (in the symtab, as they are local symbols, or the dynsym), and an alternate
+ is added on their entry point, so any call/jmp to them goes to the native function through a bridge.
+ Only the internal variant names are used ("__memmove_avx_unaligned_erms"...), not the public names, as a program
+ can define its own "memcpy" with side effects. The "_chk" variants are not redirected (different signature).
+*/
+
+#define SUPER() \
+    GO(memmove, pFppL, memmove)     \
+    GO(memcpy, pFppL, memmove)      \
+    GO(mempcpy, pFppL, mempcpy)     \
+    GO(memset, pFpiL, memset)       \
+    GO(memchr, pFpiL, memchr)       \
+    GO(memcmp, iFppL, memcmp)       \
+    GO(strlen, LFp, strlen)         \
+    GO(strnlen, LFpL, strnlen)      \
+    GO(strcmp, iFpp, strcmp)        \
+    GO(strchr, pFpi, strchr)        \
+    GO(strcpy, pFpp, strcpy)        \
+
+// suffixes of the glibc multiarch variants (sysdeps/x86_64/multiarch)
+static const char* string_variants[] = {
+    "sse2", "sse2_unaligned", "sse2_unaligned_erms", "ssse3", "sse4_1", "sse42",
+    "avx2", "avx2_rtm", "avx2_movbe", "avx2_movbe_rtm", "avx2_unaligned", "avx2_unaligned_erms",
+    "avx2_unaligned_rtm", "avx2_unaligned_erms_rtm", "avx_unaligned", "avx_unaligned_erms",
+    "avx_unaligned_rtm", "avx_unaligned_erms_rtm", "evex", "evex_movbe", "evex_unaligned",
+    "evex_unaligned_erms", "avx512_unaligned", "avx512_unaligned_erms", "erms", "no_vzeroupper",
+    NULL
+};
+
+static int isStringVariant(const char* symname, const char* base)
+{
+    // "__" base "_" variant
+    if(symname[0]!='_' || symname[1]!='_')
+        return 0;
+    size_t l = strlen(base);
+    if(strncmp(symname+2, base, l) || symname[2+l]!='_')
+        return 0;
+    const char* variant = symname+2+l+1;
+    for(int i=0; string_variants[i]; ++i)
+        if(!strcmp(variant, string_variants[i]))
+            return 1;
+    return 0;
+}
+
+static int redirectStringSymbol(elfheader_t* h, const char* symname, uintptr_t offs)
+{
+    if(strncmp(symname, "__", 2))
+        return 0;
+    #define GO(A, W, N) if(isStringVariant(symname, #A)) {                                      \
+        if(hasAlternate((void*)offs)) return 0;                                                 \
+        uintptr_t alt = AddCheckBridge(my_context->system, W, N, 0, #N);                        \
+        printf_log(LOG_DEBUG, "Redirecting %s function from %p (%s) to native " #N "\n", symname, (void*)offs, ElfName(h)); \
+        addAlternate((void*)offs, (void*)alt);                                                  \
+        return 1;                                                                               \
+    }
+    SUPER()
+    #undef GO
+    return 0;
+}
+
+void checkStringSymbols(elfheader_t* h)
+{
+    if(!box64_native_strings || box64_is32bits)
+        return;
+    int redirected = 0;
+    for (size_t i=0; i<h->numSymTab; ++i) {
+        int type = ELF64_ST_TYPE(h->SymTab._64[i].st_info);
+        if((type==STT_FUNC) && h->SymTab._64[i].st_size && (h->SymTab._64[i].st_shndx!=0 && h->SymTab._64[i].st_shndx<=65521)) {
+            const char * symname = h->StrTab+h->SymTab._64[i].st_name;
+            redirected += redirectStringSymbol(h, symname, h->SymTab._64[i].st_value + h->delta);
+        }
+    }
+    for (size_t i=0; i<h->numDynSym; ++i) {
+        int type = ELF64_ST_TYPE(h->DynSym._64[i].st_info);
+        if((type==STT_FUNC) && h->DynSym._64[i].st_size && (h->DynSym._64[i].st_shndx!=0 && h->DynSym._64[i].st_shndx<=65521)) {
+            const char * symname = h->DynStr+h->DynSym._64[i].st_name;
+            redirected += redirectStringSymbol(h, symname, h->DynSym._64[i].st_value + h->delta);
+        }
+    }
+    if(redirected)
+        printf_log(LOG_DEBUG, "Redirected %d string/memory functions to native libc for %s\n", redirected, ElfName(h));
+}
@@ -84,16 +84,57 @@ uint64_t RunFunction(uintptr_t fnc, int nargs, ...)
     return ret;
 }
 
+// RunFunctionFmt signature, parsed once and cached by format address (formats are string literals in the wrappers)
+typedef struct cbsig_s {
+    const char* fmt;
+    int         nargs;
+    int         stackn;     // stack slots, alignment included
+    int8_t      loc[];      // per arg: gpr index (int) / xmm index (f/d) if >=0, else stack slot -1-loc
+} cbsig_t;
+#define CBSIG_CACHE 256
+static cbsig_t* cbsig_cache[CBSIG_CACHE] = {0};
+
+static void ParseCallbackSig(cbsig_t* sig, const char* fmt, int nargs)
+{
+    int ni = 0, ndf = 0, ns = 0;
+    sig->fmt = fmt;
+    sig->nargs = nargs;
+    for (int i=0; i<nargs; ++i) {
+        switch(fmt[i]) {
+            case 'f':
+            case 'd': sig->loc[i] = (ndf<8)?ndf++:(-1-ns++); break;
+            default:  sig->loc[i] = (ni<6)?ni++:(-1-ns++); break;
+        }
+    }
+    sig->stackn = ns + (ns&1);
+}
+
+// return NULL if the signature can't be cached
+static cbsig_t* GetCallbackSig(const char* fmt)
+{
+    uint32_t h = (((uintptr_t)fmt)>>3)&(CBSIG_CACHE-1);
+    cbsig_t* sig = __atomic_load_n(&cbsig_cache[h], __ATOMIC_ACQUIRE);
+    if(sig)
+        return (sig->fmt==fmt)?sig:NULL;   // slot used by another format
+    int nargs = strlen(fmt);
+    sig = (cbsig_t*)box_malloc(sizeof(cbsig_t)+nargs);
+    ParseCallbackSig(sig, fmt, nargs);
+    cbsig_t* expected = NULL;
+    if(!__atomic_compare_exchange_n(&cbsig_cache[h], &expected, sig, 0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+        box_free(sig);
+        return (expected->fmt==fmt)?expected:NULL;
+    }
+    return sig;
+}
+
 EXPORTDYN
 uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
 {
     x64emu_t *emu = thread_get_emu();
     int nargs = 0;
-    int ni = 0;
-    int ndf = 0;
-    for (int i=0; fmt[i]; ++i) {
-        #ifdef BOX32
-        if(box64_is32bits)
+    #ifdef BOX32
+    if(box64_is32bits)
+        for (int i=0; fmt[i]; ++i)
             switch(fmt[i]) {
                 case 'd': 
                 case 'I': 
@@ -111,30 +152,19 @@ uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
                 default:
                     ++nargs; break;
             }
-        else
-        #endif
-        switch(fmt[i]) {
-            case 'f': 
-            case 'd': if(ndf<8) ++ndf; else ++nargs; break;
-            case 'p': 
-            case 'i': 
-            case 'u': 
-            case 'I': 
-            case 'U': 
-            case 'L': 
-            case 'l': 
-            case 'w': 
-            case 'W': 
-            case 'c': 
-            case 'C': if(ni<6) ++ni; else ++nargs; break;
-            default:
-                if(ni<6) ++ni; else ++nargs; break;
+    #endif
+    cbsig_t* sig = NULL;
+    int stackn = 0;
+    if(box64_is32bits)
+        stackn = (nargs&1) + nargs;
+    else {
+        if(!(sig = GetCallbackSig(fmt))) {
+            int n = strlen(fmt);
+            sig = (cbsig_t*)alloca(sizeof(cbsig_t)+n);
+            ParseCallbackSig(sig, fmt, n);
         }
+        stackn = sig->stackn;
     }
-    ni = 0;
-    ndf = 0;
-    int align = nargs&1;
-    int stackn = align + nargs;
     int sizeof_ptr = sizeof(void*);
     #ifdef BOX32
     if(box64_is32bits) {
@@ -187,25 +217,23 @@ uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
         uint64_t *p = (uint64_t*)R_RSP;
 
         static const int nn[] = {_DI, _SI, _DX, _CX, _R8, _R9};
-        #define GO(c, A, B, B2, C) case c: if(ni<6) emu->regs[nn[ni++]].A[0] = C va_arg(va, B2); else {*p = 0; *((B*)p) = va_arg(va, B2); ++p;}; break;
+        #define GO(c, A, B, B2, C) case c: if(l>=0) emu->regs[nn[l]].A[0] = C va_arg(va, B2); else {p[-1-l] = 0; *((B*)&p[-1-l]) = va_arg(va, B2);}; break;
         va_list va;
         va_start (va, fmt);
-        for (int i=0; fmt[i]; ++i) {
+        for (int i=0; i<sig->nargs; ++i) {
+            int l = sig->loc[i];
             switch(fmt[i]) {
-                case 'f':   if(ndf<8)
-                                emu->xmm[ndf++].f[0] = va_arg(va, double);  // float are promoted to double in ...
+                case 'f':   if(l>=0)
+                                emu->xmm[l].f[0] = va_arg(va, double);  // float are promoted to double in ...
                             else {
-                                *p = 0;
-                                *((float*)p) = va_arg(va, double);
-                                ++p;
+                                p[-1-l] = 0;
+                                *((float*)&p[-1-l]) = va_arg(va, double);
                             }
                             break;
-                case 'd':   if(ndf<8)
-                                emu->xmm[ndf++].d[0] = va_arg(va, double);
-                            else {
-                                *((double*)p) = va_arg(va, double);
-                                ++p;
-                            }
+                case 'd':   if(l>=0)
+                                emu->xmm[l].d[0] = va_arg(va, double);
+                            else
+                                *((double*)&p[-1-l]) = va_arg(va, double);
                             break;
                 GO('p', q, void*, void*, (uintptr_t))
                 GO('i', sdword, int, int, )
@@ -220,7 +248,7 @@ uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
                 GO('C', byte, uint8_t, int, )
                 default:
                     printf_log(LOG_NONE, "Error, unhandled arg %d: '%c' in RunFunctionFmt\n", i, fmt[i]);
-                    if(ni<6) emu->regs[nn[ni++]].q[0] = va_arg(va, uint64_t); else {*p = va_arg(va, uint64_t); ++p;}; 
+                    if(l>=0) emu->regs[nn[l]].q[0] = va_arg(va, uint64_t); else p[-1-l] = va_arg(va, uint64_t);
                     break;
             }
         }
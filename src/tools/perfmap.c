@@ -0,0 +1,200 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <elf.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "debug.h"
+#include "perfmap.h"
+#include "fileutils.h"
+#include "x64emu.h"
+#include "x64run.h"
+
+#ifdef DYNAREC
+// Two formats are supported:
+//  - the perf map, a simple text file "/tmp/perf-<pid>.map" with "start size name" lines,
+//    read directly by "perf report". It has no notion of time, so a native range that is freed
+//    and reused by another block will show both names (perf picks one of them)
+//  - the jitdump format (see tools/perf/Documentation/jitdump-specification.txt in linux sources),
+//    each code load record is timestamped and carries a copy of the code, so "perf inject --jit"
+//    can correctly attribute samples even when the native memory of a freed block is reused
+
+#define JITDUMP_MAGIC       0x4A695444
+#define JITDUMP_VERSION     1
+#define JIT_CODE_LOAD       0
+
+typedef struct jitdump_header_s {
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    total_size;
+    uint32_t    elf_mach;
+    uint32_t    pad1;
+    uint32_t    pid;
+    uint64_t    timestamp;
+    uint64_t    flags;
+} jitdump_header_t;
+
+typedef struct jitdump_code_load_s {
+    uint32_t    id;
+    uint32_t    total_size;
+    uint64_t    timestamp;
+    uint32_t    pid;
+    uint32_t    tid;
+    uint64_t    vma;
+    uint64_t    code_addr;
+    uint64_t    code_size;
+    uint64_t    code_index;
+    // followed by the null terminated name, then the code itself
+} jitdump_code_load_t;
+
+static pthread_mutex_t mutex_perfmap = PTHREAD_MUTEX_INITIALIZER;
+static int perfmap_fd = -1;
+static pid_t perfmap_pid = 0;
+static void* jitdump_marker = NULL;
+static uint64_t jitdump_index = 0;
+
+static uint64_t perfmap_timestamp(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);    // needs "perf record -k mono"
+    return (uint64_t)ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
+
+static uint32_t perfmap_elfmach(void)
+{
+#if defined(ARM64)
+    return EM_AARCH64;
+#elif defined(RV64)
+    return EM_RISCV;
+#elif defined(LA64)
+#ifndef EM_LOONGARCH
+#define EM_LOONGARCH 258
+#endif
+    return EM_LOONGARCH;
+#else
+    return EM_X86_64;
+#endif
+}
+
+static int perfmap_writeall(const void* p, size_t l)
+{
+    while(l) {
+        ssize_t r = write(perfmap_fd, p, l);
+        if(r<=0)
+            return -1;
+        p+=r; l-=r;
+    }
+    return 0;
+}
+
+static void perfmap_close(void)
+{
+    if(jitdump_marker) {
+        munmap(jitdump_marker, box64_pagesize);
+        jitdump_marker = NULL;
+    }
+    if(perfmap_fd!=-1)
+        close(perfmap_fd);
+    perfmap_fd = -1;
+    perfmap_pid = 0;
+}
+
+// open (or re-open after a fork) the perf map file for the current process
+static int perfmap_open(void)
+{
+    pid_t pid = getpid();
+    if(perfmap_fd!=-1 && perfmap_pid==pid)
+        return 0;
+    if(perfmap_fd!=-1)
+        perfmap_close();    // file inherited from the parent process, leave it to the parent
+    char path[4096];
+    if(box64_dynarec_perf_map==PERFMAP_JITDUMP)
+        snprintf(path, sizeof(path), "%s/jit-%d.dump", GetTmpDir(), pid);
+    else
+        snprintf(path, sizeof(path), "/tmp/perf-%d.map", pid);
+    perfmap_fd = open(path, O_CREAT|O_TRUNC|O_RDWR|O_CLOEXEC, 0644);
+    if(perfmap_fd==-1) {
+        printf_log(LOG_NONE, "Warning: cannot open perf map file %s, disabling BOX64_DYNAREC_PERFMAP\n", path);
+        box64_dynarec_perf_map = PERFMAP_NONE;
+        return -1;
+    }
+    perfmap_pid = pid;
+    jitdump_index = 0;
+    if(box64_dynarec_perf_map==PERFMAP_JITDUMP) {
+        jitdump_header_t header = {0};
+        header.magic = JITDUMP_MAGIC;
+        header.version = JITDUMP_VERSION;
+        header.total_size = sizeof(header);
+        header.elf_mach = perfmap_elfmach();
+        header.pid = pid;
+        header.timestamp = perfmap_timestamp();
+        if(perfmap_writeall(&header, sizeof(header))) {
+            printf_log(LOG_NONE, "Warning: cannot write jitdump header to %s, disabling BOX64_DYNAREC_PERFMAP\n", path);
+            perfmap_close();
+            box64_dynarec_perf_map = PERFMAP_NONE;
+            return -1;
+        }
+        // perf record spots the jitdump file thanks to this executable mmap of it
+        jitdump_marker = mmap(NULL, box64_pagesize, PROT_READ|PROT_EXEC, MAP_PRIVATE, perfmap_fd, 0);
+        if(jitdump_marker==MAP_FAILED) {
+            printf_log(LOG_INFO, "Warning: cannot mmap jitdump file %s, perf will not find it\n", path);
+            jitdump_marker = NULL;
+        }
+    }
+    printf_log(LOG_INFO, "Dynarec blocks will be written to %s\n", path);
+    return 0;
+}
+
+static void jitdump_write(const char* name, void* native, size_t native_size)
+{
+    jitdump_code_load_t rec = {0};
+    size_t name_len = strlen(name)+1;
+    rec.id = JIT_CODE_LOAD;
+    rec.total_size = sizeof(rec) + name_len + native_size;
+    rec.timestamp = perfmap_timestamp();
+    rec.pid = perfmap_pid;
+    rec.tid = GetTID();
+    rec.vma = rec.code_addr = (uintptr_t)native;
+    rec.code_size = native_size;
+    rec.code_index = jitdump_index++;
+    if(!perfmap_writeall(&rec, sizeof(rec)) && !perfmap_writeall(name, name_len))
+        perfmap_writeall(native, native_size);
+}
+
+void writePerfMap(uintptr_t x64_addr, void* native, size_t native_size)
+{
+    if(!box64_dynarec_perf_map || !native || !native_size)
+        return;
+    pthread_mutex_lock(&mutex_perfmap);
+    if(!perfmap_open()) {
+        char name[1100];
+        const char* fnc = getAddrFunctionName(x64_addr);
+        if(!fnc || !strcmp(fnc, "???"))
+            snprintf(name, sizeof(name), "x64@%p", (void*)x64_addr);
+        else
+            snprintf(name, sizeof(name), "%s (x64@%p)", fnc, (void*)x64_addr);
+        if(box64_dynarec_perf_map==PERFMAP_JITDUMP)
+            jitdump_write(name, native, native_size);
+        else
+            dprintf(perfmap_fd, "%lx %zx %s\n", (uintptr_t)native, native_size, name);
+    }
+    pthread_mutex_unlock(&mutex_perfmap);
+}
+
+void closePerfMap(void)
+{
+    pthread_mutex_lock(&mutex_perfmap);
+    if(perfmap_pid==getpid())
+        perfmap_close();
+    pthread_mutex_unlock(&mutex_perfmap);
+}
+#else
+void writePerfMap(uintptr_t x64_addr, void* native, size_t native_size) {}
+void closePerfMap(void) {}
+#endif
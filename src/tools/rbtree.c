@@ -21,6 +21,7 @@
 typedef struct rbnode {
     struct rbnode *left, *right, *parent;
     uintptr_t start, end;
+    uintptr_t min_start, max_end, max_gap;  // span and biggest free gap between the ranges of the subtree
     uint32_t data;
     uint8_t meta;
 } rbnode;
@@ -51,6 +52,36 @@ void delete_rbtree(rbtree *tree) {
 #define IS_LEFT  0x1
 #define IS_BLACK 0x2
 
+static inline uintptr_t gap_size(uintptr_t end, uintptr_t start) {
+    return (start > end) ? (start - end) : 0;
+}
+// Recompute the subtree info of node from its children
+static void update_gap(rbnode *node) {
+    uintptr_t gap = 0, g;
+    node->min_start = node->start;
+    node->max_end = node->end;
+    if (node->left) {
+        node->min_start = node->left->min_start;
+        gap = node->left->max_gap;
+        g = gap_size(node->left->max_end, node->start);
+        if (g > gap) gap = g;
+    }
+    if (node->right) {
+        node->max_end = node->right->max_end;
+        if (node->right->max_gap > gap) gap = node->right->max_gap;
+        g = gap_size(node->end, node->right->min_start);
+        if (g > gap) gap = g;
+    }
+    node->max_gap = gap;
+}
+// Recompute the subtree info of node and all its ancestors
+static void update_gap_up(rbnode *node) {
+    while (node) {
+        update_gap(node);
+        node = node->parent;
+    }
+}
+
 // Make sure prev is either the rightmost node before start or the leftmost range after start
 int add_range_next_to(rbtree *tree, rbnode *prev, uintptr_t start, uintptr_t end, uint32_t data) {
 // printf("Adding %lX-%lX:%hhX next to %p\n", start, end, data, prev);
@@ -71,6 +102,7 @@ int add_range_next_to(rbtree *tree, rbnode *prev, uintptr_t start, uintptr_t end
         node->parent = NULL;
         node->meta = IS_BLACK;
         tree->root = node;
+        update_gap(node);
         tree->is_unstable = 0;
         return 0;
     }
@@ -83,6 +115,7 @@ int add_range_next_to(rbtree *tree, rbnode *prev, uintptr_t start, uintptr_t end
         prev->left = node;
         node->meta = IS_LEFT;
     }
+    update_gap_up(node);
     
     while (!(node->meta & IS_BLACK)) {
         if (!node->parent) {
@@ -129,6 +162,8 @@ int add_range_next_to(rbtree *tree, rbnode *prev, uintptr_t start, uintptr_t end
                         z->right->meta &= ~IS_LEFT;
                         z->right->parent = z;
                     }
+                    update_gap(z);
+                    update_gap(y);
                     node = z;
                 }
                 rbnode *y, *z;
@@ -156,6 +191,8 @@ int add_range_next_to(rbtree *tree, rbnode *prev, uintptr_t start, uintptr_t end
                     z->left->meta |= IS_LEFT;
                     z->left->parent = z;
                 }
+                update_gap(z);
+                update_gap(y);
                 if (!y->parent) tree->root = y;
                 tree->is_unstable = 0;
                 return 0;
@@ -190,6 +227,8 @@ int add_range_next_to(rbtree *tree, rbnode *prev, uintptr_t start, uintptr_t end
                         z->left->meta |= IS_LEFT;
                         z->left->parent = z;
                     }
+                    update_gap(z);
+                    update_gap(y);
                     node = z;
                 }
                 rbnode *y, *z;
@@ -217,6 +256,8 @@ int add_range_next_to(rbtree *tree, rbnode *prev, uintptr_t start, uintptr_t end
                     z->right->meta &= ~IS_LEFT;
                     z->right->parent = z;
                 }
+                update_gap(z);
+                update_gap(y);
                 if (!y->parent) tree->root = y;
                 tree->is_unstable = 0;
                 return 0;
@@ -321,6 +362,7 @@ int remove_node(rbtree *tree, rbnode *node) {
         }
     }
     // Node has been removed, now to fix the tree
+    update_gap_up(parent);
     if (!(node->meta & IS_BLACK)) {
         rbtreeFree(node);
         tree->is_unstable = 0;
@@ -361,6 +403,8 @@ int remove_node(rbtree *tree, rbnode *node) {
                     z->right->meta &= ~IS_LEFT;
                     z->right->parent = z;
                 }
+                update_gap(z);
+                update_gap(y);
                 // ===
                 node = parent->right;
             }
@@ -390,6 +434,8 @@ int remove_node(rbtree *tree, rbnode *node) {
                     z->right->meta &= ~IS_LEFT;
                     z->right->parent = z;
                 }
+                update_gap(z);
+                update_gap(y);
                 if (!y->parent) tree->root = y;
                 node->right->meta |= IS_BLACK;
                 tree->is_unstable = 0;
@@ -423,6 +469,8 @@ int remove_node(rbtree *tree, rbnode *node) {
                     z->left->meta |= IS_LEFT;
                     z->left->parent = z;
                 }
+                update_gap(z);
+                update_gap(y);
                 node = y;
                 goto case4_l;
             }
@@ -454,6 +502,8 @@ int remove_node(rbtree *tree, rbnode *node) {
                     z->left->meta |= IS_LEFT;
                     z->left->parent = z;
                 }
+                update_gap(z);
+                update_gap(y);
                 if (!y->parent) tree->root = y;
                 // ===
                 node = parent->left;
@@ -484,6 +534,8 @@ int remove_node(rbtree *tree, rbnode *node) {
                     z->left->meta |= IS_LEFT;
                     z->left->parent = z;
                 }
+                update_gap(z);
+                update_gap(y);
                 if (!y->parent) tree->root = y;
                 node->left->meta |= IS_BLACK;
                 tree->is_unstable = 0;
@@ -517,6 +569,8 @@ int remove_node(rbtree *tree, rbnode *node) {
                     z->right->meta &= ~IS_LEFT;
                     z->right->parent = z;
                 }
+                update_gap(z);
+                update_gap(y);
                 node = y;
                 goto case4_r;
             }
@@ -629,10 +683,13 @@ dynarec_log(LOG_DEBUG, "set 0x%lX, 0x%lX, 0x%x\n", start, end, data);
         if (node && (node->end > end)) {
             node->start = end;
             prev->end = end;
+            update_gap_up(node);
+            update_gap_up(prev);
             return 0;
         } else if (node && (node->end == end)) {
             remove_node(tree, node);
             prev->end = end;
+            update_gap_up(prev);
             return 0;
         } else if (node) {
             remove_node(tree, node);
@@ -647,10 +704,15 @@ dynarec_log(LOG_DEBUG, "set 0x%lX, 0x%lX, 0x%x\n", start, end, data);
             // Merge node and last
             prev->end = last->end;
             remove_node(tree, last);
+            update_gap_up(prev);
             return 0;
         }
-        if (last && (last->start < end)) last->start = end;
+        if (last && (last->start < end)) {
+            last->start = end;
+            update_gap_up(last);
+        }
         prev->end = end;
+        update_gap_up(prev);
         return 0;
     } else if (prev && (prev->end > start)) {
         if (prev->end > end) {
@@ -660,10 +722,12 @@ dynarec_log(LOG_DEBUG, "set 0x%lX, 0x%lX, 0x%x\n", start, end, data);
             ret = add_range_next_to(tree, prev->right ? last : prev, end, prev->end, prev->data);
             ret = ret ? ret : add_range_next_to(tree, prev->right ? succ_node(prev) : prev, start, end, data);
             prev->end = start;
+            update_gap_up(prev);
             return ret;
         }
         // Cut prev and continue
         prev->end = start;
+        update_gap_up(prev);
     }
 
     if (node) {
@@ -675,6 +739,7 @@ dynarec_log(LOG_DEBUG, "set 0x%lX, 0x%lX, 0x%x\n", start, end, data);
                 int ret = add_range_next_to(tree, node->right ? last : node, end, node->end, node->data);
                 node->end = end;
                 node->data = data;
+                update_gap_up(node);
                 return ret;
             }
             // Fallthrough
@@ -691,10 +756,17 @@ dynarec_log(LOG_DEBUG, "set 0x%lX, 0x%lX, 0x%x\n", start, end, data);
             // Merge node and last
             remove_node(tree, node);
             last->start = start;
+            update_gap_up(last);
             return 0;
         }
-        if (last && (last->start < end)) last->start = end;
-        if (node->end < end) node->end = end;
+        if (last && (last->start < end)) {
+            last->start = end;
+            update_gap_up(last);
+        }
+        if (node->end < end) {
+            node->end = end;
+            update_gap_up(node);
+        }
         node->data = data;
         return 0;
     }
@@ -713,10 +785,12 @@ dynarec_log(LOG_DEBUG, "set 0x%lX, 0x%lX, 0x%x\n", start, end, data);
     if ((last->start <= end) && (last->data == data)) {
         // Extend
         last->start = start;
+        update_gap_up(last);
         return 0;
     } else if (last->start < end) {
         // Cut
         last->start = end;
+        update_gap_up(last);
     }
     // Probably 'last->left ? prev : last' is enough
     return add_range_next_to(tree, last->left ? pred_node(last) : last, start, end, data);
@@ -751,6 +825,7 @@ dynarec_log(LOG_DEBUG, "rb_unset(tree, 0x%lX, 0x%lX);\n", start, end);
     if (node) {
         if (node->end > end) {
             node->start = end;
+            update_gap_up(node);
             return 0;
         } else if (node->end == end) {
             remove_node(tree, node);
@@ -763,9 +838,11 @@ dynarec_log(LOG_DEBUG, "rb_unset(tree, 0x%lX, 0x%lX);\n", start, end);
             // Split prev
             int ret = add_range_next_to(tree, prev->right ? next : prev, end, prev->end, prev->data);
             prev->end = start;
+            update_gap_up(prev);
             return ret;
         } else if (prev->end == end) {
             prev->end = start;
+            update_gap_up(prev);
             return 0;
         } // else fallthrough
     }
@@ -778,10 +855,36 @@ dynarec_log(LOG_DEBUG, "rb_unset(tree, 0x%lX, 0x%lX);\n", start, end);
     if (next && (next->start < end)) {
         // next->end > end: cut the node
         next->start = end;
+        update_gap_up(next);
     }
     return 0;
 }
 
+static int find_free_gap(uintptr_t gs, uintptr_t ge, uintptr_t start, uintptr_t limit, uintptr_t size, uintptr_t mask, uintptr_t *ret) {
+    uintptr_t addr = start;
+    if (gs > start) {
+        addr = (gs + mask) & ~mask;
+        if (addr < gs) return 0; // overflow
+    }
+    if ((addr >= limit) || (addr >= ge) || (ge - addr < size)) return 0;
+    *ret = addr;
+    return 1;
+}
+// lend is the end of the range just before the subtree (or 0), rstart the start of the range just after (or -1)
+static int find_free(rbnode *node, uintptr_t lend, uintptr_t rstart, uintptr_t start, uintptr_t limit, uintptr_t size, uintptr_t mask, uintptr_t *ret) {
+    if (!node) return find_free_gap(lend, rstart, start, limit, size, mask, ret);
+    if ((rstart <= start) || (lend >= limit)) return 0;
+    if ((node->max_gap < size) && (gap_size(lend, node->min_start) < size) && (gap_size(node->max_end, rstart) < size))
+        return 0;
+    if (find_free(node->left, lend, node->start, start, limit, size, mask, ret)) return 1;
+    return find_free(node->right, node->end, rstart, start, limit, size, mask, ret);
+}
+uintptr_t rb_find_free(rbtree *tree, uintptr_t start, uintptr_t limit, uintptr_t size, uintptr_t mask) {
+    uintptr_t ret = 0;
+    if (!find_free(tree->root, 0, (uintptr_t)-1, start, limit, size, mask, &ret)) return 0;
+    return ret;
+}
+
 uintptr_t rb_get_righter(rbtree* tree)
 {
 dynarec_log(LOG_DEBUG, "rb_get_righter(tree);\n");
@@ -98,6 +98,9 @@ ENTRYBOOL(BOX64_PREFER_EMULATED, box64_prefer_emulated) \
 ENTRYBOOL(BOX64_CRASHHANDLER, box64_dummy_crashhandler) \
 ENTRYBOOL(BOX64_NOPULSE, box64_nopulse)                 \
 ENTRYBOOL(BOX64_NOGTK, box64_nogtk)                     \
+ENTRYBOOL(BOX64_RELOCCACHE, box64_reloc_cache)          \
+ENTRYINTPOS(BOX64_RELOC_THREADS, box64_reloc_threads)   \
+ENTRYBOOL(BOX64_NATIVE_STRINGS, box64_native_strings)   \
 ENTRYBOOL(BOX64_NOVULKAN, box64_novulkan)               \
 ENTRYBOOL(BOX64_RDTSC_1GHZ, box64_rdtsc_1ghz)           \
 ENTRYBOOL(BOX64_SHAEXT, box64_shaext)                   \
@@ -155,6 +158,12 @@ ENTRYINT(BOX64_DYNAREC_LOG, box64_dynarec_log, 0, 3, 2)             \
 ENTRYINT(BOX64_DYNAREC_BIGBLOCK, box64_dynarec_bigblock, 0, 3, 2)   \
 ENTRYSTRING_(BOX64_DYNAREC_FORWARD, box64_dynarec_forward)          \
 ENTRYINT(BOX64_DYNAREC_STRONGMEM, box64_dynarec_strongmem, 0, 4, 3) \
+ENTRYBOOL(BOX64_DYNAREC_STRONGMEM_AUTO, box64_dynarec_strongmem_auto) \
+ENTRYBOOL(BOX64_DYNAREC_RCPC, box64_dynarec_rcpc)                   \
+ENTRYBOOL(BOX64_DYNAREC_SVE, box64_dynarec_sve)                     \
+ENTRYBOOL(BOX64_DYNAREC_NATIVEFLAGS, box64_dynarec_nativeflags)     \
+ENTRYBOOL(BOX64_DYNAREC_DEADFLAGS, box64_dynarec_deadflags)         \
+ENTRYBOOL(BOX64_DYNAREC_STOREFWD, box64_dynarec_storefwd)           \
 ENTRYBOOL(BOX64_DYNAREC_X87DOUBLE, box64_dynarec_x87double)         \
 ENTRYBOOL(BOX64_DYNAREC_DIV0, box64_dynarec_div0)                   \
 ENTRYBOOL(BOX64_DYNAREC_FASTNAN, box64_dynarec_fastnan)             \
@@ -168,9 +177,11 @@ IGNORE(BOX64_DYNAREC_HOTPAGE)                                       \
 IGNORE(BOX64_DYNAREC_FASTPAGE)                                      \
 ENTRYBOOL(BOX64_DYNAREC_ALIGNED_ATOMICS, box64_dynarec_aligned_atomics) \
 ENTRYBOOL(BOX64_DYNAREC_WAIT, box64_dynarec_wait)                   \
+ENTRYBOOL(BOX64_DYNAREC_SYSCALL, box64_dynarec_syscall)             \
 ENTRYSTRING_(BOX64_NODYNAREC, box64_nodynarec)                      \
 ENTRYSTRING_(BOX64_DYNAREC_TEST, box64_dynarec_test)                \
 ENTRYBOOL(BOX64_DYNAREC_MISSING, box64_dynarec_missing)             \
+ENTRYINT(BOX64_DYNAREC_PERFMAP, box64_dynarec_perf_map, 0, 2, 2)    \
 
 #else
 #define SUPER3()                                                    \
@@ -180,6 +191,12 @@ IGNORE(BOX64_DYNAREC_LOG)                                           \
 IGNORE(BOX64_DYNAREC_BIGBLOCK)                                      \
 IGNORE(BOX64_DYNAREC_FORWARD)                                       \
 IGNORE(BOX64_DYNAREC_STRONGMEM)                                     \
+IGNORE(BOX64_DYNAREC_STRONGMEM_AUTO)                                \
+IGNORE(BOX64_DYNAREC_RCPC)                                          \
+IGNORE(BOX64_DYNAREC_SVE)                                           \
+IGNORE(BOX64_DYNAREC_NATIVEFLAGS)                                   \
+IGNORE(BOX64_DYNAREC_DEADFLAGS)                                     \
+IGNORE(BOX64_DYNAREC_STOREFWD)                                      \
 IGNORE(BOX64_DYNAREC_X87DOUBLE)                                     \
 IGNORE(BOX64_DYNAREC_DIV0)                                          \
 IGNORE(BOX64_DYNAREC_FASTNAN)                                       \
@@ -193,9 +210,11 @@ IGNORE(BOX64_DYNAREC_HOTPAGE)                                       \
 IGNORE(BOX64_DYNAREC_FASTPAGE)                                      \
 IGNORE(BOX64_DYNAREC_ALIGNED_ATOMICS)                               \
 IGNORE(BOX64_DYNAREC_WAIT)                                          \
+IGNORE(BOX64_DYNAREC_SYSCALL)                                       \
 IGNORE(BOX64_NODYNAREC)                                             \
 IGNORE(BOX64_DYNAREC_TEST)                                          \
 IGNORE(BOX64_DYNAREC_MISSING)                                       \
+IGNORE(BOX64_DYNAREC_PERFMAP)                                       \
 
 #endif
 
@@ -2148,6 +2148,40 @@ EXPORT void* my_ldiv(x64emu_t* emu, void* p, int32_t num, int32_t den)
 #endif
 
 #ifndef NOALIGN
+// native epoll_event array for epoll_wait & co: on the stack for small maxevents,
+// else a per thread scratch buffer, grown to the largest maxevents seen by the thread
+#define EPOLL_STACK_EVENTS  64
+typedef struct epoll_scratch_s {
+    int                 size;
+    struct epoll_event  events[];
+} epoll_scratch_t;
+static pthread_key_t epoll_scratch_key;
+static pthread_once_t epoll_scratch_once = PTHREAD_ONCE_INIT;
+static void epoll_scratch_free(void* p)
+{
+    box_free(p);
+}
+static void epoll_scratch_init(void)
+{
+    pthread_key_create(&epoll_scratch_key, epoll_scratch_free);
+}
+static struct epoll_event* getEpollScratch(struct epoll_event* stack, int maxevents)
+{
+    if(maxevents<=EPOLL_STACK_EVENTS)
+        return stack;
+    pthread_once(&epoll_scratch_once, epoll_scratch_init);
+    epoll_scratch_t* scratch = (epoll_scratch_t*)pthread_getspecific(epoll_scratch_key);
+    if(!scratch || scratch->size<maxevents) {
+        epoll_scratch_t* tmp = (epoll_scratch_t*)box_realloc(scratch, sizeof(epoll_scratch_t)+maxevents*sizeof(struct epoll_event));
+        if(!tmp)
+            return NULL;
+        scratch = tmp;
+        scratch->size = maxevents;
+        pthread_setspecific(epoll_scratch_key, scratch);
+    }
+    return scratch->events;
+}
+
 EXPORT int32_t my_epoll_ctl(x64emu_t* emu, int32_t epfd, int32_t op, int32_t fd, void* event)
 {
     struct epoll_event _event[1] = {0};
@@ -2157,26 +2191,39 @@ EXPORT int32_t my_epoll_ctl(x64emu_t* emu, int32_t epfd, int32_t op, int32_t fd,
 }
 EXPORT int32_t my_epoll_wait(x64emu_t* emu, int32_t epfd, void* events, int32_t maxevents, int32_t timeout)
 {
-    struct epoll_event _events[maxevents];
-    //AlignEpollEvent(_events, events, maxevents);
-    int32_t ret = epoll_wait(epfd, events?_events:NULL, maxevents, timeout);
+    struct epoll_event stack[EPOLL_STACK_EVENTS];
+    struct epoll_event* _events = events?getEpollScratch(stack, maxevents):NULL;
+    if(events && !_events) {
+        errno = ENOMEM;
+        return -1;
+    }
+    int32_t ret = epoll_wait(epfd, _events, maxevents, timeout);
     if(ret>0)
         UnalignEpollEvent(events, _events, ret);
     return ret;
 }
 EXPORT int32_t my_epoll_pwait(x64emu_t* emu, int32_t epfd, void* events, int32_t maxevents, int32_t timeout, const sigset_t *sigmask)
 {
-    struct epoll_event _events[maxevents];
-    //AlignEpollEvent(_events, events, maxevents);
-    int32_t ret = epoll_pwait(epfd, events?_events:NULL, maxevents, timeout, sigmask);
+    struct epoll_event stack[EPOLL_STACK_EVENTS];
+    struct epoll_event* _events = events?getEpollScratch(stack, maxevents):NULL;
+    if(events && !_events) {
+        errno = ENOMEM;
+        return -1;
+    }
+    int32_t ret = epoll_pwait(epfd, _events, maxevents, timeout, sigmask);
     if(ret>0)
         UnalignEpollEvent(events, _events, ret);
     return ret;
 }
 EXPORT int32_t my_epoll_pwait2(x64emu_t* emu, int32_t epfd, void* events, int32_t maxevents, const struct timespec* timeout, const sigset_t* sigmask)
 {
-    struct epoll_event _events[maxevents];
-    int32_t ret = epoll_pwait2(epfd, events?_events:NULL, maxevents, timeout, sigmask);
+    struct epoll_event stack[EPOLL_STACK_EVENTS];
+    struct epoll_event* _events = events?getEpollScratch(stack, maxevents):NULL;
+    if(events && !_events) {
+        errno = ENOMEM;
+        return -1;
+    }
+    int32_t ret = epoll_pwait2(epfd, _events, maxevents, timeout, sigmask);
     if(ret>0)
         UnalignEpollEvent(events, _events, ret);
     return ret;
@@ -2988,6 +3035,10 @@ EXPORT void* my_mmap64(x64emu_t* emu, void *addr, unsigned long length, int prot
         }
     }
     #endif
+    #if defined(__NR_io_uring_setup)
+    if(ret!=MAP_FAILED && (flags&MAP_SHARED) && fd>=0 && !box64_is32bits)
+        iouring_mmap(fd, offset, ret);
+    #endif
     if(ret!=MAP_FAILED) {
         if((flags&MAP_SHARED) && (fd>0)) {
             uint32_t flags = fcntl(fd, F_GETFL);
@@ -3083,6 +3134,9 @@ EXPORT int my_munmap(x64emu_t* emu, void* addr, unsigned long length)
     #endif
     if(!ret) {
         freeProtection((uintptr_t)addr, length);
+        #if defined(__NR_io_uring_setup)
+        iouring_munmap(addr, length);
+        #endif
     }
     return ret;
 }
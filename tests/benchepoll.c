@@ -0,0 +1,89 @@
+/*
+** Epoll benchmark: events per second returned by epoll_wait
+**
+** NFD eventfds are kept readable (level triggered), so every epoll_wait call
+** returns min(NFD, maxevents) events. The data field of each event is checked,
+** to catch any packing problem with the x86_64 struct epoll_event.
+**
+** To compile:  cc -O2 -o benchepoll benchepoll.c
+** Usage:       benchepoll [nfd [maxevents [seconds]]]
+** Run it natively and with box64 to compare the numbers.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+int main(int argc, char** argv)
+{
+    int nfd = (argc>1)?atoi(argv[1]):256;
+    int maxevents = (argc>2)?atoi(argv[2]):nfd;
+    double seconds = (argc>3)?atof(argv[3]):2.0;
+    if(nfd<1 || maxevents<1) {
+        printf("Usage: %s [nfd [maxevents [seconds]]]\n", argv[0]);
+        return 1;
+    }
+    int ep = epoll_create1(0);
+    if(ep<0) {
+        perror("epoll_create1");
+        return 1;
+    }
+    int* fds = calloc(nfd, sizeof(int));
+    for(int i=0; i<nfd; ++i) {
+        fds[i] = eventfd(1, 0);
+        if(fds[i]<0) {
+            perror("eventfd");
+            return 1;
+        }
+        struct epoll_event ev = {0};
+        ev.events = EPOLLIN;
+        ev.data.u64 = 0x1234567800000000ULL | i;
+        if(epoll_ctl(ep, EPOLL_CTL_ADD, fds[i], &ev)) {
+            perror("epoll_ctl");
+            return 1;
+        }
+    }
+    struct epoll_event* events = calloc(maxevents, sizeof(struct epoll_event));
+    long calls = 0;
+    long total = 0;
+    double start = now();
+    double end = start;
+    while(end-start<seconds) {
+        for(int k=0; k<1000; ++k) {
+            int n = epoll_wait(ep, events, maxevents, 0);
+            if(n<0) {
+                perror("epoll_wait");
+                return 1;
+            }
+            for(int i=0; i<n; ++i)
+                if(events[i].events!=EPOLLIN || (events[i].data.u64>>32)!=0x12345678 || (events[i].data.u64&0xffffffff)>=(uint64_t)nfd) {
+                    printf("Bad event %d: events=0x%x data=0x%llx\n", i, events[i].events, (unsigned long long)events[i].data.u64);
+                    return 1;
+                }
+            total += n;
+        }
+        calls += 1000;
+        end = now();
+    }
+    double t = end-start;
+    printf("%d fds, maxevents=%d: %ld calls, %ld events in %.2fs\n", nfd, maxevents, calls, total, t);
+    printf("%.0f calls/s, %.0f events/s, %.1f ns/event\n", calls/t, total/t, t*1e9/total);
+    for(int i=0; i<nfd; ++i)
+        close(fds[i]);
+    close(ep);
+    free(events);
+    free(fds);
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+** Lock benchmark: lock-heavy code relying on x86_64 memory ordering (TSO)
+**
+** - "spinlock": threads take a LOCK CMPXCHG spinlock, update a few plain
+**   counters and release the lock with a plain MOV store
+** - "message": a producer fills a buffer with plain stores then publishes a
+**   sequence number (plain store), a consumer waits for the sequence number
+**   and checks the buffer (plain loads)
+** Both only work on a weakly ordered host if the x86 ordering is emulated
+** (BOX64_DYNAREC_STRONGMEM or BOX64_DYNAREC_STRONGMEM_AUTO), errors are counted.
+**
+** To compile:  cc -O2 -pthread -o benchlock benchlock.c
+** Usage:       benchlock [threads [iterations]]
+** Run it natively and with box64 (and different STRONGMEM settings) to compare the numbers.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define NDATA   8
+
+static volatile int lock;
+static volatile uint64_t counter[4];
+static long iterations;
+
+static volatile uint64_t seq;
+static volatile uint64_t data[NDATA];
+static long errors;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void spin_lock(volatile int* l)
+{
+    while(__sync_val_compare_and_swap(l, 0, 1))
+        while(*l)
+            sched_yield();
+}
+
+static void spin_unlock(volatile int* l)
+{
+    __asm__ __volatile__("" ::: "memory");
+    *l = 0; // plain store, release on x86
+}
+
+static void* spin_thread(void* arg)
+{
+    (void)arg;
+    for(long i=0; i<iterations; ++i) {
+        spin_lock(&lock);
+        uint64_t v = counter[0];
+        counter[0] = v+1;
+        counter[1] = v+1;
+        counter[2] += 2;
+        counter[3] = counter[1]+counter[2];
+        spin_unlock(&lock);
+    }
+    return NULL;
+}
+
+static void* producer(void* arg)
+{
+    (void)arg;
+    for(long i=1; i<=iterations; ++i) {
+        while(seq!=2*i-2)
+            sched_yield();
+        for(int j=0; j<NDATA; ++j)
+            data[j] = i*NDATA+j;
+        __asm__ __volatile__("" ::: "memory");
+        seq = 2*i-1;
+    }
+    return NULL;
+}
+
+static void* consumer(void* arg)
+{
+    (void)arg;
+    for(long i=1; i<=iterations; ++i) {
+        while(seq!=2*i-1)
+            sched_yield();
+        __asm__ __volatile__("" ::: "memory");
+        for(int j=0; j<NDATA; ++j)
+            if(data[j]!=(uint64_t)(i*NDATA+j))
+                ++errors;
+        __asm__ __volatile__("" ::: "memory");
+        seq = 2*i;
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv)
+{
+    int nthreads = (argc>1)?atoi(argv[1]):4;
+    iterations = (argc>2)?atol(argv[2]):1000000;
+    if(nthreads<1 || iterations<1) {
+        printf("Usage: %s [threads [iterations]]\n", argv[0]);
+        return 1;
+    }
+    pthread_t* th = calloc(nthreads, sizeof(pthread_t));
+    double t = now();
+    for(int i=0; i<nthreads; ++i)
+        pthread_create(&th[i], NULL, spin_thread, NULL);
+    for(int i=0; i<nthreads; ++i)
+        pthread_join(th[i], NULL);
+    t = now()-t;
+    uint64_t expected = (uint64_t)nthreads*iterations;
+    int bad = (counter[0]!=expected || counter[1]!=expected || counter[2]!=2*expected || counter[3]!=3*expected);
+    printf("spinlock: %d threads, %.0f lock/unlock per second%s\n", nthreads, expected/t, bad?" (BAD COUNTERS)":"");
+
+    pthread_t p, c;
+    t = now();
+    pthread_create(&p, NULL, producer, NULL);
+    pthread_create(&c, NULL, consumer, NULL);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+    t = now()-t;
+    printf("message: %.0f messages per second, %ld errors\n", iterations/t, errors);
+    free(th);
+    return (bad || errors)?2:0;
+}
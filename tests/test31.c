@@ -0,0 +1,249 @@
+// io_uring test, with raw syscalls (no liburing)
+// build with gcc -O2 test31.c -o test31
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <linux/io_uring.h>
+
+typedef struct ring_s {
+    int fd;
+    struct io_uring_params p;
+    uint8_t* sq;
+    uint8_t* cq;
+    struct io_uring_sqe* sqes;
+} ring_t;
+
+static int setup(ring_t* r, unsigned entries)
+{
+    memset(r, 0, sizeof(*r));
+    r->fd = syscall(__NR_io_uring_setup, entries, &r->p);
+    if(r->fd<0)
+        return -1;
+    size_t sqsz = r->p.sq_off.array + r->p.sq_entries*sizeof(uint32_t);
+    size_t cqsz = r->p.cq_off.cqes + r->p.cq_entries*sizeof(struct io_uring_cqe);
+    if(r->p.features&IORING_FEAT_SINGLE_MMAP) {
+        if(cqsz>sqsz) sqsz = cqsz;
+    }
+    r->sq = mmap(NULL, sqsz, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if(r->sq==MAP_FAILED)
+        return -1;
+    if(r->p.features&IORING_FEAT_SINGLE_MMAP)
+        r->cq = r->sq;
+    else {
+        r->cq = mmap(NULL, cqsz, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+        if(r->cq==MAP_FAILED)
+            return -1;
+    }
+    r->sqes = mmap(NULL, r->p.sq_entries*sizeof(struct io_uring_sqe), PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, r->fd, IORING_OFF_SQES);
+    if(r->sqes==MAP_FAILED)
+        return -1;
+    return 0;
+}
+
+static struct io_uring_sqe* get_sqe(ring_t* r)
+{
+    uint32_t tail = *(uint32_t*)(r->sq+r->p.sq_off.tail);
+    uint32_t mask = *(uint32_t*)(r->sq+r->p.sq_off.ring_mask);
+    uint32_t idx = tail&mask;
+    ((uint32_t*)(r->sq+r->p.sq_off.array))[idx] = idx;
+    struct io_uring_sqe* sqe = &r->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    __atomic_store_n((uint32_t*)(r->sq+r->p.sq_off.tail), tail+1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+// submit all pending sqes, wait for them and print the completions in user_data order
+static void submit_wait(ring_t* r, int n)
+{
+    int ret = syscall(__NR_io_uring_enter, r->fd, n, n, IORING_ENTER_GETEVENTS, NULL, 0);
+    if(ret!=n)
+        printf("io_uring_enter returned %d (errno=%d)\n", ret, errno);
+    int64_t res[16];
+    int got = 0;
+    while(got<n) {
+        uint32_t head = *(uint32_t*)(r->cq+r->p.cq_off.head);
+        uint32_t tail = __atomic_load_n((uint32_t*)(r->cq+r->p.cq_off.tail), __ATOMIC_ACQUIRE);
+        uint32_t mask = *(uint32_t*)(r->cq+r->p.cq_off.ring_mask);
+        struct io_uring_cqe* cqes = (struct io_uring_cqe*)(r->cq+r->p.cq_off.cqes);
+        if(head==tail) {
+            syscall(__NR_io_uring_enter, r->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+            continue;
+        }
+        while(head!=tail) {
+            struct io_uring_cqe* cqe = &cqes[head&mask];
+            if(cqe->user_data<16)
+                res[cqe->user_data] = cqe->res;
+            ++head;
+            ++got;
+        }
+        __atomic_store_n((uint32_t*)(r->cq+r->p.cq_off.head), head, __ATOMIC_RELEASE);
+    }
+    for(int i=0; i<n; ++i)
+        printf("  cqe %d: res=%s%lld\n", i, (res[i]<0)?"-":"", (long long)((res[i]<0)?-res[i]:res[i]));
+}
+
+int main(int argc, char** argv)
+{
+    ring_t r;
+    if(setup(&r, 8)) {
+        // io_uring can be disabled (sysctl kernel.io_uring_disabled, seccomp...)
+        fprintf(stderr, "io_uring not available (errno=%d)\n", errno);
+        return 1;
+    }
+    printf("io_uring_setup: sq_entries=%u cq_entries=%u\n", r.p.sq_entries, r.p.cq_entries);
+
+    char path[256];
+    snprintf(path, sizeof(path), "/tmp/box64_test31_%d", getpid());
+    unlink(path);
+
+    // 1: nop, openat with O_CREAT (flags are arch specific)
+    printf("nop + openat:\n");
+    struct io_uring_sqe* sqe = get_sqe(&r);
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = 0;
+    sqe = get_sqe(&r);
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uintptr_t)path;
+    sqe->open_flags = O_CREAT|O_RDWR|O_TRUNC|O_CLOEXEC|O_NOFOLLOW;
+    sqe->len = 0644;
+    sqe->user_data = 1;
+    int ret = syscall(__NR_io_uring_enter, r.fd, 2, 2, IORING_ENTER_GETEVENTS, NULL, 0);
+    if(ret!=2)
+        printf("io_uring_enter returned %d\n", ret);
+    int fd = -1;
+    {
+        uint32_t head = *(uint32_t*)(r.cq+r.p.cq_off.head);
+        uint32_t tail = __atomic_load_n((uint32_t*)(r.cq+r.p.cq_off.tail), __ATOMIC_ACQUIRE);
+        uint32_t mask = *(uint32_t*)(r.cq+r.p.cq_off.ring_mask);
+        struct io_uring_cqe* cqes = (struct io_uring_cqe*)(r.cq+r.p.cq_off.cqes);
+        for(; head!=tail; ++head) {
+            struct io_uring_cqe* cqe = &cqes[head&mask];
+            if(cqe->user_data==0)
+                printf("  nop: res=%d\n", cqe->res);
+            else {
+                printf("  openat: %s\n", (cqe->res>=0)?"ok":strerror(-cqe->res));
+                fd = cqe->res;
+            }
+        }
+        __atomic_store_n((uint32_t*)(r.cq+r.p.cq_off.head), head, __ATOMIC_RELEASE);
+    }
+    if(fd<0)
+        return 2;
+    int flags = fcntl(fd, F_GETFD);
+    printf("  O_CLOEXEC set: %d\n", (flags&FD_CLOEXEC)?1:0);
+
+    // 2: openat of a regular file with O_DIRECTORY must fail with ENOTDIR
+    printf("openat O_DIRECTORY:\n");
+    sqe = get_sqe(&r);
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uintptr_t)path;
+    sqe->open_flags = O_RDONLY|O_DIRECTORY;
+    sqe->user_data = 0;
+    submit_wait(&r, 1);
+
+    // 3: write then read back, linked
+    printf("write + read:\n");
+    const char msg[] = "Hello from io_uring";
+    char buf[64] = {0};
+    sqe = get_sqe(&r);
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = (uintptr_t)msg;
+    sqe->len = sizeof(msg)-1;
+    sqe->off = 0;
+    sqe->flags = IOSQE_IO_LINK;
+    sqe->user_data = 0;
+    sqe = get_sqe(&r);
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uintptr_t)buf;
+    sqe->len = sizeof(buf)-1;
+    sqe->off = 0;
+    sqe->user_data = 1;
+    submit_wait(&r, 2);
+    printf("  read back: \"%s\"\n", buf);
+
+    // 4: statx
+    printf("statx:\n");
+    struct statx stx;
+    memset(&stx, 0, sizeof(stx));
+    sqe = get_sqe(&r);
+    sqe->opcode = IORING_OP_STATX;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uintptr_t)path;
+    sqe->len = STATX_SIZE|STATX_TYPE;
+    sqe->off = (uintptr_t)&stx;
+    sqe->statx_flags = 0;
+    sqe->user_data = 0;
+    submit_wait(&r, 1);
+    printf("  size=%llu regular=%d\n", (unsigned long long)stx.stx_size, S_ISREG(stx.stx_mode)?1:0);
+
+    // 5: epoll_ctl (struct epoll_event is packed on x86_64)
+    printf("epoll_ctl:\n");
+    int ep = epoll_create1(0);
+    int efd = eventfd(1, 0);
+    struct epoll_event ev = {0};
+    ev.events = EPOLLIN;
+    ev.data.u64 = 0x1122334455667788ULL;
+    sqe = get_sqe(&r);
+    sqe->opcode = IORING_OP_EPOLL_CTL;
+    sqe->fd = ep;
+    sqe->off = efd;
+    sqe->len = EPOLL_CTL_ADD;
+    sqe->addr = (uintptr_t)&ev;
+    sqe->user_data = 0;
+    submit_wait(&r, 1);
+    struct epoll_event out[2];
+    memset(out, 0, sizeof(out));
+    int n = epoll_wait(ep, out, 2, 1000);
+    printf("  epoll_wait: %d event, events=0x%x data=0x%llx\n", n, out[0].events, (unsigned long long)out[0].data.u64);
+
+    // 6: openat of /proc/self/exe must give the program, not the emulator
+    printf("openat /proc/self/exe:\n");
+    sqe = get_sqe(&r);
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uintptr_t)"/proc/self/exe";
+    sqe->open_flags = O_RDONLY|O_CLOEXEC;
+    sqe->user_data = 0;
+    syscall(__NR_io_uring_enter, r.fd, 1, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+    {
+        uint32_t head = *(uint32_t*)(r.cq+r.p.cq_off.head);
+        uint32_t mask = *(uint32_t*)(r.cq+r.p.cq_off.ring_mask);
+        struct io_uring_cqe* cqes = (struct io_uring_cqe*)(r.cq+r.p.cq_off.cqes);
+        int exefd = cqes[head&mask].res;
+        __atomic_store_n((uint32_t*)(r.cq+r.p.cq_off.head), head+1, __ATOMIC_RELEASE);
+        struct stat st1, st2;
+        int same = (exefd>=0) && !fstat(exefd, &st1) && !stat(argv[0], &st2) && st1.st_dev==st2.st_dev && st1.st_ino==st2.st_ino;
+        printf("  same file as argv[0]: %d\n", same);
+        if(exefd>=0)
+            close(exefd);
+    }
+
+    // 7: close
+    printf("close:\n");
+    sqe = get_sqe(&r);
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = fd;
+    sqe->user_data = 0;
+    submit_wait(&r, 1);
+
+    close(efd);
+    close(ep);
+    unlink(path);
+    close(r.fd);
+    printf("done\n");
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdint.h>
+// Build with `gcc -march=core2 -O0 test32.c -o test32`
+// store to load forwarding in a block (BOX64_DYNAREC_STOREFWD)
+
+static uint64_t cell;
+
+// same base, a later overlapping write must be seen by the load
+uint64_t overlap(uint64_t* p, uint64_t a, uint32_t b, uint8_t c)
+{
+    uint64_t ret;
+    asm volatile (
+        "mov %1, (%2)           \n\t"
+        "mov %k3, 4(%2)         \n\t"
+        "mov %4, 1(%2)          \n\t"
+        "mov (%2), %0           \n\t"
+    : "=&r" (ret) : "r" (a), "r" (p), "r" (b), "q" (c) : "memory");
+    return ret;
+}
+
+// the base register changes between the store and the load
+uint64_t base_change(uint64_t* p, uint64_t a)
+{
+    uint64_t ret;
+    asm volatile (
+        "mov %1, (%2)           \n\t"
+        "add $8, %2             \n\t"
+        "mov (%2), %0           \n\t"
+    : "=&r" (ret), "+r" (a), "+r" (p) : : "memory");
+    return ret;
+}
+
+// the index register changes between the store and the load
+uint64_t index_change(uint64_t* p, uint64_t a, uint64_t i)
+{
+    uint64_t ret;
+    asm volatile (
+        "mov %1, (%2,%3,8)      \n\t"
+        "inc %3                 \n\t"
+        "mov (%2,%3,8), %0      \n\t"
+    : "=&r" (ret), "+r" (a), "+r" (p), "+r" (i) : : "memory");
+    return ret;
+}
+
+// the source register changes between the store and the load
+uint64_t src_change(uint64_t* p, uint64_t a)
+{
+    uint64_t ret;
+    asm volatile (
+        "mov %1, (%2)           \n\t"
+        "mov $5, %k1            \n\t"
+        "mov (%2), %0           \n\t"
+        "add %1, %0             \n\t"
+    : "=&r" (ret), "+r" (a) : "r" (p) : "memory");
+    return ret;
+}
+
+// 32bits store then 64bits load, and 64bits store then 32bits load
+uint64_t size_mismatch(uint64_t* p, uint64_t a, uint64_t b)
+{
+    uint64_t ret, ret2;
+    asm volatile (
+        "mov %2, (%3)           \n\t"
+        "mov %k4, (%3)          \n\t"
+        "mov (%3), %0           \n\t"
+        "mov %4, 8(%3)          \n\t"
+        "mov 8(%3), %k1         \n\t"
+    : "=&r" (ret), "=&r" (ret2) : "r" (a), "r" (p), "r" (b) : "memory");
+    return ret+ret2;
+}
+
+// RIP relative cell, also written through a pointer before the load
+uint64_t rip_cell(uint64_t* p, uint64_t a, uint64_t b)
+{
+    uint64_t ret, ret2;
+    asm volatile (
+        "mov %2, cell(%%rip)    \n\t"
+        "mov cell(%%rip), %0    \n\t"
+        "mov %3, (%4)           \n\t"
+        "mov cell(%%rip), %1    \n\t"
+    : "=&r" (ret), "=&r" (ret2) : "r" (a), "r" (b), "r" (p) : "memory");
+    return ret^(ret2<<1);
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t buf[4] = {0};
+    printf("overlap: 0x%016llx\n", (unsigned long long)overlap(buf, 0x1111111111111111ULL, 0x22222222, 0x33));
+    buf[1] = 0x4444444444444444ULL;
+    printf("base change: 0x%016llx\n", (unsigned long long)base_change(buf, 0x5555555555555555ULL));
+    buf[2] = 0x6666666666666666ULL;
+    printf("index change: 0x%016llx\n", (unsigned long long)index_change(buf, 0x7777777777777777ULL, 1));
+    printf("src change: 0x%016llx\n", (unsigned long long)src_change(buf, 0x8888888888888888ULL));
+    printf("size mismatch: 0x%016llx\n", (unsigned long long)size_mismatch(buf, 0x9999999999999999ULL, 0xaaaaaaaabbbbbbbbULL));
+    printf("rip cell: 0x%016llx\n", (unsigned long long)rip_cell(&cell, 0x0123456789abcdefULL, 0xfedcba9876543210ULL));
+    return 0;
+}
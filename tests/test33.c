@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdint.h>
+// Build with `gcc -march=core2 -O0 test33.c -o test33`
+// flags set before the end of a block and read after it (BOX64_DYNAREC_DEADFLAGS)
+
+// CF from the CMP read after a jmp, by an opcode that doesn't set CF
+uint64_t jmp_inc(uint64_t a, uint64_t b)
+{
+    uint64_t ret = 0;
+    asm volatile (
+        "cmp %2, %1             \n\t"
+        "jmp 1f                 \n\t"
+        "nop                    \n\t"
+        "1:                     \n\t"
+        "mov $3, %k0            \n\t"
+        "lea 1(%0), %0          \n\t"
+        "inc %0                 \n\t"
+        "adc $0x10, %0          \n\t"
+    : "+r" (ret) : "r" (a), "r" (b) : "cc");
+    return ret;
+}
+
+// flags from a function read by the caller after the ret
+asm(
+"below:                 \n\t"
+"    cmp %rsi, %rdi     \n\t"
+"    ret                \n\t"
+);
+
+uint64_t ret_setb(uint64_t a, uint64_t b)
+{
+    uint64_t ret;
+    asm volatile (
+        "mov %1, %%rdi          \n\t"
+        "mov %2, %%rsi          \n\t"
+        "call below             \n\t"
+        "mov $0, %k0            \n\t"
+        "setb %b0               \n\t"
+        "seto %%dl              \n\t"
+        "movzbl %%dl, %%edx     \n\t"
+        "lea (%0,%%rdx,2), %0   \n\t"
+    : "=&q" (ret) : "r" (a), "r" (b) : "rdi", "rsi", "rdx", "cc", "memory");
+    return ret;
+}
+
+// flags read after a conditional jump to code past many nops, then overwritten
+uint64_t far_jcc(uint64_t a, uint64_t b)
+{
+    uint64_t ret = 0;
+    asm volatile (
+        "sub %2, %1             \n\t"
+        "jz 1f                  \n\t"
+        ".fill 80, 1, 0x90      \n\t"
+        "1:                     \n\t"
+        "mov $0, %k0            \n\t"
+        "sbb %0, %0             \n\t"
+        "add $1, %1             \n\t"
+        "adc %1, %0             \n\t"
+    : "+r" (ret), "+r" (a) : "r" (b) : "cc");
+    return ret;
+}
+
+int main(int argc, char** argv)
+{
+    printf("jmp inc: %llu %llu\n", (unsigned long long)jmp_inc(1, 2), (unsigned long long)jmp_inc(2, 1));
+    printf("ret setb: %llu %llu %llu\n", (unsigned long long)ret_setb(1, 2), (unsigned long long)ret_setb(2, 1),
+        (unsigned long long)ret_setb(0x8000000000000000ULL, 1));
+    printf("far jcc: %llu %llu %llu\n", (unsigned long long)far_jcc(1, 2), (unsigned long long)far_jcc(5, 5),
+        (unsigned long long)far_jcc(7, 2));
+    return 0;
+}